@@ -0,0 +1,96 @@
+#ifndef ID_SERVICE_H
+#define ID_SERVICE_H
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*!
+ * @file id_service.h
+ *
+ * @brief Thread-safe allocation of the unique ids of entities, neurons and
+ * links.
+ */
+
+/*!
+ * @class IdService
+ *
+ * @brief Hands out unique 64-bit ids without a global lock.
+ *
+ * @details Each kind of id has its own atomic counter. A thread reserves a
+ * block of kBlockSize ids with a single atomic add and serves further
+ * requests from it, so threads spawning entities in parallel neither collide
+ * nor contend. In deterministic mode, used by seeded runs
+ * (SETTINGS.random.input_seed), blocks are disabled and ids are consecutive
+ * in allocation order, as with the former static counters.
+ *
+ * Allocation order is only fixed on one thread. A parallel loop creating
+ * objects therefore reserves a Batch beforehand, and each iteration takes
+ * its ids from the range of its index through a ScopedJob, so the ids depend
+ * on the iteration and not on the thread running it. Loops whose iterations
+ * need different numbers of ids count them first, Reserve the total and give
+ * each job its slice.
+ *
+ * Ids read back from a save are passed to Observe, which moves the counter
+ * past them and retires the blocks already handed out.
+ */
+class IdService {
+ public:
+  enum Kind { kEntity, kNeuron, kLink, kKindCount };
+
+  static constexpr std::int64_t kBlockSize = 256;
+
+  /*!
+   * @brief Ids reserved for the jobs of one parallel loop, see ReserveBatch.
+   */
+  struct Batch {
+    std::int64_t first[kKindCount] = {};   /*!< First id of job 0. */
+    std::int64_t per_job[kKindCount] = {}; /*!< Ids in the range of a job. */
+  };
+
+  class ScopedJob;
+
+  static std::int64_t Next(Kind kind);
+  static std::int64_t Reserve(Kind kind, std::int64_t count);
+  static Batch ReserveBatch(int jobs,
+                            const std::int64_t (&per_job)[kKindCount]);
+  static void Observe(Kind kind, std::int64_t id);
+  static void Reset(Kind kind, std::int64_t first_id);
+  static std::int64_t Peek(Kind kind);
+
+ private:
+  struct Block {
+    std::int64_t next = 0; /*!< Next id of the block. */
+    std::int64_t end = 0;  /*!< One past the last id of the block. */
+    long epoch = -1;       /*!< Epoch the block was reserved in. */
+  };
+
+  static std::atomic<std::int64_t> next_[kKindCount]; /*!< First free id. */
+  static std::atomic<long> epoch_[kKindCount]; /*!< Bumped to retire blocks. */
+  static thread_local Block blocks_[kKindCount]; /*!< Per-thread blocks. */
+};
+
+/*!
+ * @class IdService::ScopedJob
+ *
+ * @brief Makes the calling thread take its ids from the range of one job of a
+ * Batch, and restores its blocks afterwards.
+ *
+ * @details A job needing more ids than reserved goes on with the usual
+ * allocation, which is unique but no longer independent of the schedule.
+ */
+class IdService::ScopedJob {
+ public:
+  ScopedJob(const Batch& batch, int job);
+  ScopedJob(Kind kind, std::int64_t first, std::int64_t count);
+  ~ScopedJob();
+
+  ScopedJob(const ScopedJob&) = delete;
+  ScopedJob& operator=(const ScopedJob&) = delete;
+
+ private:
+  Block saved_[kKindCount]; /*!< Blocks of the thread before the job. */
+};
+
+#endif  // ID_SERVICE_H
@@ -13,26 +13,60 @@ private:
     static std::random_device rd; //Tbh I think this is a lil useless but I can't think of a better way rn
     static thread_local std::mt19937_64 engine;
 
+    /*!
+     * @class Stream
+     *
+     * @brief Generator of a ScopedSeed, splitmix64 over a counter: seeding it
+     * is a single store, unlike the engine whose state is 312 words.
+     */
+    class Stream
+    {
+    public:
+        using result_type = uint64_t;
+
+        explicit Stream(uint64_t seed) : state_(seed) {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return UINT64_MAX; }
+
+        result_type operator()()
+        {
+            state_ += kGolden;
+            return Finalise(state_);
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    static thread_local Stream* stream; /*!< Innermost ScopedSeed, or null. */
+
+    template<typename Distribution>
+    static typename Distribution::result_type Draw(Distribution& dist)
+    {
+        return stream ? dist(*stream) : dist(engine);
+    }
+
 public:
     template<typename U, typename V>
     static int Int(U min, V max)
     {
         std::uniform_int_distribution<int> dist(min, max);
-        return dist(engine);
+        return Draw(dist);
     }
 
     template<typename U, typename V>
     static double Double(U min, V max)
     {
         std::uniform_real_distribution<double> dist(min, max);
-        return dist(engine);
+        return Draw(dist);
     }
 
     template<typename U, typename V>
     static double Normal(U mean, V sigma)
     {
         std::normal_distribution<double> dist(mean, sigma);
-        return dist(engine);
+        return Draw(dist);
     }
 
     template<typename T>
@@ -40,7 +74,7 @@ public:
     {
         std::uniform_int_distribution<int> dist(0, 1);
 
-        if (dist(engine) == 0)
+        if (Draw(dist) == 0)
             return first;
         return second;
     }
@@ -50,13 +84,81 @@ public:
             engine.seed(seed);
         }
 
-    static void InitializeThreadLocalEngine() {
+    static uint64_t Bits()
+    {
+        return stream ? (*stream)() : engine();
+    }
+
+    /*!
+     * @class ScopedSeed
+     *
+     * @brief Makes the calling thread draw from a stream of its own for one
+     * job, and from its engine again afterwards.
+     *
+     * @details The stream is seeded from a base seed, drawn once per batch,
+     * and the index of the job, so the draws of a job don't depend on the
+     * thread running it nor on the jobs run before it. The stream is a
+     * counter, so a scope costs a few instructions and can be opened for
+     * every creature of every tick.
+     */
+    class ScopedSeed
+    {
+    public:
+        ScopedSeed(uint64_t base, uint64_t job)
+            : stream_(Mix(base, job)), saved_(stream)
+        {
+            stream = &stream_;
+        }
+
+        ~ScopedSeed()
+        {
+            stream = saved_;
+        }
+
+        ScopedSeed(const ScopedSeed&) = delete;
+        ScopedSeed& operator=(const ScopedSeed&) = delete;
+
+    private:
+        Stream stream_;
+        Stream* saved_; /*!< Stream of the enclosing scope, if any. */
+    };
+
+    /*!
+     * @brief Seeds the engine of the calling thread from the settings.
+     *
+     * @param stream 0 for the simulation thread, the index of the thread
+     * otherwise, so that every thread of a seeded run draws its own stream.
+     */
+    static void InitializeThreadLocalEngine(uint64_t stream = 0) {
         if (SETTINGS.random.input_seed){
-            engine.seed(SETTINGS.random.seed);
+            engine.seed(stream == 0 ? SETTINGS.random.seed
+                                    : Mix(SETTINGS.random.seed, stream));
         } else {
             std::random_device rd;
                 engine.seed(rd());
         }
     }
+
+private:
+    static constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ULL;
+
+    /*!
+     * @brief The splitmix64 finaliser.
+     */
+    static uint64_t Finalise(uint64_t seed)
+    {
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+        return seed ^ (seed >> 31);
+    }
+
+    /*!
+     * @brief Seed of a job from a base seed, the splitmix64 finaliser
+     * decorrelates consecutive jobs.
+     */
+    static uint64_t Mix(uint64_t base, uint64_t job)
+    {
+        return Finalise(base + (job + 1) * kGolden);
+    }
 };
 #endif // RANDOM_H
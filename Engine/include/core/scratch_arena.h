@@ -0,0 +1,101 @@
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/*!
+ * @file scratch_arena.h
+ *
+ * @brief Per-thread memory for the temporaries of one tick.
+ */
+
+/*!
+ * @class ScratchArena
+ *
+ * @brief A bump allocator, one per thread, rewound at the end of every tick.
+ *
+ * @details Allocations advance a pointer in the current block and are never
+ * freed one by one. When a block is full a larger one is chained; on Reset the
+ * chain is replaced by a single block as large as all of them, so once the
+ * arena has seen the largest tick it allocates nothing from the heap.
+ *
+ * Memory from the arena is only valid until the next ResetAll, which the
+ * simulation calls at the end of FixedUpdate while no loop is running.
+ * Containers over the arena must not outlive the tick nor be handed to
+ * another thread.
+ */
+class ScratchArena {
+ public:
+  static ScratchArena &Local();
+  static void ResetAll();
+
+  ScratchArena();
+  ~ScratchArena();
+  ScratchArena(const ScratchArena &) = delete;
+  ScratchArena &operator=(const ScratchArena &) = delete;
+
+  void *Allocate(std::size_t bytes, std::size_t alignment);
+  void Reset();
+
+  std::size_t GetCapacity() const;
+  int GetBlockCount() const;
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t size;
+  };
+
+  void AddBlock(std::size_t size);
+  std::size_t AlignedOffset(const std::byte *memory,
+                            std::size_t alignment) const;
+
+  std::vector<Block> blocks_; /*!< The last one is being filled. */
+  std::size_t used_ = 0;      /*!< Bytes taken in the last block. */
+};
+
+/*!
+ * @class ArenaAllocator
+ *
+ * @brief Standard allocator drawing from the ScratchArena of the thread which
+ * created it; deallocate does nothing.
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  ArenaAllocator() : arena_(&ScratchArena::Local()) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena_) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, std::size_t) {}
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const {
+    return arena_ == other.arena_;
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const {
+    return arena_ != other.arena_;
+  }
+
+ private:
+  template <typename U>
+  friend class ArenaAllocator;
+
+  ScratchArena *arena_;
+};
+
+/*!
+ * @brief A vector for the temporaries of one tick, see ScratchArena.
+ */
+template <typename T>
+using ScratchVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif  // SCRATCH_ARENA_H
@@ -3,6 +3,7 @@
 #include <cmath>  // Added for M_PI
 #include <fstream>
 #include <iostream>
+#include <string>
 
 class Settings {
  public:
@@ -45,6 +46,8 @@ class Settings {
     double mutables_compatibility = 0.5;
     double compatibility_threshold = 2.0;
     double compatibility_distance = 400.0;
+    int compatibility_cache_size = 65536;
+    double species_refresh_interval = 10.0;
   } compatibility;
 
   struct EnvironmentSettings {
@@ -71,6 +74,7 @@ class Settings {
     double reproduction_cooldown = 10;
     int input_neurons = 12;
     int output_neurons = 4;
+    int vision_rays = 0;  // rays of the ray-cast vision module, 0 disables it
     double max_nutritional_value = 2;
     double default_lifespan = 30;
     double photosynthesis_factor = 0.01;
@@ -89,6 +93,12 @@ class Settings {
     double eps = 1e-7;
     size_t max_cells_to_find_food = 30;
     double max_food_density_colored = 5e-4;
+    int vision_refresh_interval = 4;  // thinks between full vision scans
+    double think_skip_tolerance = 0;  // relative input change reusing outputs, 0 disables
+    std::string brain_precision = "double";  // double, float or int8
+    bool validate_brain_precision = false;  // measure the drift from double
+    int threads = 0;  // threads of the pool including the caller, 0 uses every core
+    bool pin_threads = false;  // bind each worker thread to one core
   } engine;
 
   struct PhysicalConstraintsSettings {
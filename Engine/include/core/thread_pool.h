@@ -0,0 +1,249 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "core/scratch_arena.h"
+
+/*!
+ * @file thread_pool.h
+ *
+ * @brief The worker threads of the engine.
+ */
+
+/*!
+ * @class ThreadPool
+ *
+ * @brief A work-stealing pool running the parallel loops of the engine.
+ *
+ * @details A loop is cut into chunks which are dealt round-robin to one queue
+ * per thread. Every thread pops from the back of its own queue and, once it is
+ * empty, steals from the front of the others, so threads which drew cheap
+ * chunks take over the work of the ones which drew expensive chunks. The
+ * thread calling a loop runs chunks too and returns once they are all done.
+ * Loops may be nested: a chunk starting a loop helps with the work until its
+ * loop is done instead of blocking a worker.
+ *
+ * Only one thread outside the pool, the simulation thread, starts loops. It
+ * is thread 0, the workers are threads 1 to GetThreadCount() - 1, see
+ * ThreadIndex. Keeping the thread count fixed and the other numerical
+ * libraries sequential avoids oversubscribing the cores when the engine is
+ * embedded next to other pools.
+ */
+class ThreadPool {
+ public:
+  static ThreadPool &Global();
+
+  explicit ThreadPool(int threads = 0, bool pin = false);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void Resize(int threads, bool pin);
+  int GetThreadCount() const;
+  static int ThreadIndex();
+
+  template <typename Body>
+  void ParallelForRange(int begin, int end, Body &&body, int grain = 0);
+  template <typename Body>
+  void ParallelFor(int begin, int end, Body &&body, int grain = 0);
+  template <typename Cost, typename Body>
+  void ParallelForWeighted(int begin, int end, Cost &&cost, Body &&body);
+  template <typename T, typename Map, typename Reduce>
+  T ParallelReduce(int begin, int end, T identity, Map &&map, Reduce &&reduce,
+                   int grain = 0);
+
+ private:
+  /*!
+   * @brief One loop: the body and the number of chunks left to run.
+   */
+  struct Job {
+    void (*run)(const void *body, int begin, int end);
+    const void *body;
+    std::atomic<int> pending;
+    std::mutex error_mutex;
+    std::exception_ptr error; /*!< First exception thrown by a chunk. */
+  };
+
+  /*!
+   * @brief A chunk of a loop, the iterations [begin, end).
+   */
+  struct Task {
+    Job *job;
+    int begin;
+    int end;
+  };
+
+  /*!
+   * @brief The chunks dealt to one thread.
+   */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void Start(int threads, bool pin);
+  void Stop();
+  void Run(Job &job, const ScratchVector<int> &bounds);
+  bool RunOne(int self);
+  bool Pop(int queue, bool back, Task &task);
+  void WorkerLoop(int index, bool pin);
+  int DefaultGrain(int count) const;
+
+  std::vector<std::unique_ptr<Queue>> queues_; /*!< One per thread. */
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<int> queued_{0}; /*!< Chunks waiting in the queues. */
+  bool pin_ = false;           /*!< Whether the workers are pinned. */
+  bool stopping_ = false;      /*!< Guarded by sleep_mutex_. */
+};
+
+/*!
+ * @brief Runs body(chunk_begin, chunk_end) over chunks of [begin, end).
+ *
+ * @details Lets the body vectorise within its chunk. Chunks hold grain
+ * iterations; by default each thread gets about eight of them, enough for
+ * stealing to even out the load.
+ *
+ * @param begin First iteration.
+ * @param end One past the last iteration.
+ * @param body Called once per chunk, from any thread of the pool.
+ * @param grain Iterations per chunk, 0 picks one from the thread count.
+ */
+template <typename Body>
+void ThreadPool::ParallelForRange(int begin, int end, Body &&body, int grain) {
+  if (end <= begin) return;
+  if (grain <= 0) grain = DefaultGrain(end - begin);
+  if (queues_.size() == 1 || end - begin <= grain) {
+    body(begin, end);
+    return;
+  }
+  ScratchVector<int> bounds;
+  bounds.reserve((end - begin + grain - 1) / grain + 1);
+  for (int i = begin; i < end; i += grain) bounds.push_back(i);
+  bounds.push_back(end);
+
+  using B = std::remove_reference_t<Body>;
+  Job job;
+  job.run = [](const void *b, int first, int last) {
+    (*static_cast<B *>(const_cast<void *>(b)))(first, last);
+  };
+  job.body = &body;
+  Run(job, bounds);
+}
+
+/*!
+ * @brief Runs body(i) for every i in [begin, end).
+ *
+ * @param begin First iteration.
+ * @param end One past the last iteration.
+ * @param body Called once per iteration, from any thread of the pool.
+ * @param grain Iterations per chunk, 0 picks one from the thread count.
+ */
+template <typename Body>
+void ThreadPool::ParallelFor(int begin, int end, Body &&body, int grain) {
+  ParallelForRange(
+      begin, end,
+      [&body](int first, int last) {
+        for (int i = first; i < last; i++) body(i);
+      },
+      grain);
+}
+
+/*!
+ * @brief Runs body(i) for every i in [begin, end), in chunks of similar cost.
+ *
+ * @details For loops whose iterations cost very different amounts, such as
+ * creatures which think this tick and creatures which don't. The estimates are
+ * summed serially, so they must be much cheaper than the body.
+ *
+ * @param begin First iteration.
+ * @param end One past the last iteration.
+ * @param cost cost(i), a non negative estimate of the cost of iteration i.
+ * @param body Called once per iteration, from any thread of the pool.
+ */
+template <typename Cost, typename Body>
+void ThreadPool::ParallelForWeighted(int begin, int end, Cost &&cost,
+                                     Body &&body) {
+  if (end <= begin) return;
+  if (queues_.size() == 1) {
+    for (int i = begin; i < end; i++) body(i);
+    return;
+  }
+  ScratchVector<double> costs(end - begin);
+  double total = 0;
+  for (int i = begin; i < end; i++) {
+    costs[i - begin] = std::max(0.0, static_cast<double>(cost(i)));
+    total += costs[i - begin];
+  }
+  const double target = total / (8 * queues_.size());
+
+  ScratchVector<int> bounds;
+  bounds.reserve(end - begin + 1);
+  bounds.push_back(begin);
+  double chunk = 0;
+  for (int i = begin; i < end; i++) {
+    chunk += costs[i - begin];
+    if (chunk >= target && i + 1 < end) {
+      bounds.push_back(i + 1);
+      chunk = 0;
+    }
+  }
+  bounds.push_back(end);
+
+  auto range = [&body](int first, int last) {
+    for (int i = first; i < last; i++) body(i);
+  };
+  Job job;
+  job.run = [](const void *b, int first, int last) {
+    (*static_cast<const decltype(range) *>(b))(first, last);
+  };
+  job.body = &range;
+  Run(job, bounds);
+}
+
+/*!
+ * @brief Combines map(i) over [begin, end).
+ *
+ * @details Each chunk folds its iterations in order, then the partial results
+ * are folded in chunk order, so for a given thread count and grain the result
+ * does not depend on the schedule.
+ *
+ * @param begin First iteration.
+ * @param end One past the last iteration.
+ * @param identity Neutral element of reduce.
+ * @param map map(i), the value of iteration i.
+ * @param reduce reduce(a, b), associative.
+ * @param grain Iterations per chunk, 0 picks one from the thread count.
+ */
+template <typename T, typename Map, typename Reduce>
+T ThreadPool::ParallelReduce(int begin, int end, T identity, Map &&map,
+                             Reduce &&reduce, int grain) {
+  if (end <= begin) return identity;
+  if (grain <= 0) grain = DefaultGrain(end - begin);
+  const int chunks = (end - begin + grain - 1) / grain;
+  ScratchVector<T> partials(chunks, identity);
+  ParallelForRange(
+      begin, end,
+      [&](int first, int last) {
+        T value = identity;
+        for (int i = first; i < last; i++) value = reduce(value, map(i));
+        partials[(first - begin) / grain] = value;
+      },
+      grain);
+  T value = identity;
+  for (const T &partial : partials) value = reduce(value, partial);
+  return value;
+}
+
+#endif  // THREAD_POOL_H
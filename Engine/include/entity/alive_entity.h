@@ -7,7 +7,9 @@
 
 class AliveEntity : virtual public Entity {
  public:
-  AliveEntity(neat::Genome genome, Mutable mutable_);
+  AliveEntity(const neat::Genome& genome, const Mutable& mutable_);
+  AliveEntity(std::shared_ptr<const neat::Genome> genome,
+              const Mutable& mutable_);
   virtual ~AliveEntity() override {}
 
   void Dies();
@@ -27,8 +29,11 @@ class AliveEntity : virtual public Entity {
   void SetAge(double age);
   void UpdateAge(double delta_time);
 
-  neat::Genome GetGenome() const;
-  Mutable GetMutable() const;
+  const neat::Genome& GetGenome() const;
+  std::shared_ptr<const neat::Genome> GetSharedGenome() const;
+  const Mutable& GetMutable() const;
+  std::size_t GetGenomeHash() const;
+  double BrainDistance(const AliveEntity& other) const;
 
   int GetGeneration() const;
   void SetGeneration(int generation);
@@ -45,8 +50,12 @@ class AliveEntity : virtual public Entity {
 
   neat::NeuralNetwork brain_; /*!< Neural network for processing environmental
                                  stimuli and decision making. */
-  neat::Genome genome_;       /*!< Genetic makeup of the creature. */
+  std::shared_ptr<const neat::Genome>
+      genome_; /*!< Genetic makeup of the creature, shared with its clones
+                  and immutable: mutations produce a new genome. */
+  std::size_t genome_hash_; /*!< Cached genome_->GetHash(). */
   std::vector<double> neuron_data_; /*!< Vector for the neural inputs */
+  std::vector<double> brain_output_; /*!< Reused buffer for neural outputs */
 
   int generation_ = 0; /*!< Generation count of the creature. */
 };
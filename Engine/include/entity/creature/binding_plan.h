@@ -0,0 +1,96 @@
+#ifndef BINDING_PLAN_H
+#define BINDING_PLAN_H
+
+#include <cstdint>
+#include <vector>
+
+#include "neat/genome.h"
+
+/*!
+ * @file binding_plan.h
+ *
+ * @brief Wiring between a creature's senses and actuators and its brain.
+ */
+
+/*!
+ * @struct SensorBinding
+ *
+ * @brief Writes one sense of the creature to the neural inputs.
+ */
+struct SensorBinding {
+  enum Kind : std::uint8_t {
+    kBias,
+    kEnergy,
+    kHealth,
+    kVelocity,
+    kVelocityAngle,
+    kRotationalVelocity,
+    kEmptiness,
+    kVision,      /*!< 5 inputs: distance, orientation, size, color, mate. */
+    kGeolocation, /*!< 3 inputs: x, y and orientation. */
+    kPheromone,
+    kRays, /*!< 3 inputs per ray: distance, kind and hue of the first hit. */
+  };
+
+  Kind kind;
+  int source; /*!< Entity in sight for kVision, pheromone type for
+                 kPheromone, number of rays for kRays, unused otherwise. */
+  int destination; /*!< First neural input written. */
+
+  int Width() const;
+};
+
+/*!
+ * @struct ActuatorBinding
+ *
+ * @brief Applies one neural output to the creature.
+ */
+struct ActuatorBinding {
+  enum Kind : std::uint8_t {
+    kAcceleration,
+    kAccelerationAngle,
+    kRotationalAcceleration,
+    kAttack,
+    kPheromoneEmission,
+  };
+
+  Kind kind;
+  int source; /*!< Neural output read. */
+  int target; /*!< Pheromone type for kPheromoneEmission, unused otherwise. */
+};
+
+/*!
+ * @class BindingPlan
+ *
+ * @brief The senses and actuators of a creature, compiled once from its
+ * genome.
+ *
+ * @details The brain modules of a genome never change, so instead of walking
+ * them and dispatching on their ids on every think, a creature compiles them
+ * at birth into two flat lists. Bindings whose inputs or outputs fall outside
+ * the network are dropped, so executing the plan needs no bounds checks.
+ * Sensors are listed in the order the inputs used to be filled: the fixed
+ * inputs, the first vision slot, then the modules in genome order.
+ */
+class BindingPlan {
+ public:
+  static constexpr int kPheromoneTypes = 16;
+
+  BindingPlan() = default;
+  BindingPlan(const neat::Genome& genome, int input_count, int output_count);
+
+  const std::vector<SensorBinding>& GetSensors() const { return sensors_; }
+  const std::vector<ActuatorBinding>& GetActuators() const {
+    return actuators_;
+  }
+
+ private:
+  void AddSensor(SensorBinding sensor, int input_count);
+  void AddActuator(ActuatorBinding::Kind kind, int source, int target,
+                   int output_count);
+
+  std::vector<SensorBinding> sensors_;     /*!< Run by Creature::Sense. */
+  std::vector<ActuatorBinding> actuators_; /*!< Run by Creature::Act. */
+};
+
+#endif  // BINDING_PLAN_H
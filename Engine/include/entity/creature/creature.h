@@ -6,9 +6,12 @@
 
 #include "entity/food.h"
 #include "neat/neural_network.h"
+#include "neat/neural_network_batch.h"
 
 #include "entity/movable_entity.h"
+#include "entity/locomotion_batch.h"
 #include "entity/alive_entity.h"
+#include "entity/creature/binding_plan.h"
 #include "entity/creature/vision_system.h"
 #include "entity/creature/digestive_system.h"
 #include "entity/creature/reproduction.h"
@@ -47,7 +50,8 @@ class Creature : virtual public MovableEntity,
                  virtual public MaleReproductiveSystem,
                  virtual public FemaleReproductiveSystem {
  public:
-  Creature(neat::Genome genome, Mutable mutable_);
+  Creature(const neat::Genome& genome, const Mutable& mutable_);
+  Creature(std::shared_ptr<const neat::Genome> genome, const Mutable& mutable_);
   virtual ~Creature() override {}
 
   int GetSpecies() const;
@@ -61,6 +65,10 @@ class Creature : virtual public MovableEntity,
   void Update(double deltaTime, double const kMapWidth, double const kMapHeight,
               std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
               double GridCellSize, double frictional_coefficient);
+  void UpdateKinematics(double deltaTime, double const kMapWidth,
+                        double const kMapHeight, double frictional_coefficient);
+  void QueueKinematics(LocomotionBatch &batch, double frictional_coefficient);
+  void UpdateMetabolism(double deltaTime);
 
   void OnCollision(std::shared_ptr<Entity>other_entity, double const kMapWidth,
                    double const kMapHeight) override;
@@ -68,6 +76,11 @@ class Creature : virtual public MovableEntity,
   void Grow(double energy);
   void Think(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
              double GridCellSize, double deltaTime, double width, double height);
+  bool Sense(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+             double GridCellSize, double width, double height);
+  bool ThinksNextSense() const;
+  bool QueueThink(neat::NeuralNetworkBatch &batch);
+  void Act();
 
 
   void Bite(std::shared_ptr<Creature> creature);
@@ -82,12 +95,19 @@ class Creature : virtual public MovableEntity,
       double grid_cell_size, double map_width, double map_heigth);
 
   bool GetMatingDesire() const;
+  const BindingPlan& GetBindingPlan() const;
 
  protected:
+  bool NeedsActivation();
+
   int think_count_; /*! Keeps track so that creatures think every 5 loops */
   bool mating_desire_; /*! Indicates whether creature currently wants to mate <-
                         TO BE INTEGRATED INTO REPRODUCTIVE SYSTEM*/
   bool attack_; /*! Indicates whether creature currently wants to attack */
   int species_id_;
+  BindingPlan bindings_; /*!< Senses and actuators wired to the brain. */
+  std::vector<double> last_inputs_; /*!< Inputs of the last activation. */
+
+  friend class MetabolismBatch;
 };
 #endif  // CREATURE_HPP
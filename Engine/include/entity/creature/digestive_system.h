@@ -6,7 +6,7 @@
 
 class DigestiveSystem : virtual public AliveEntity {
 public:
-  DigestiveSystem(neat::Genome genome, Mutable mutables);
+  DigestiveSystem(const neat::Genome& genome, const Mutable& mutables);
   virtual ~DigestiveSystem() override {}
   double GetStomachCapacity() const;
   double GetStomachFullness() const;
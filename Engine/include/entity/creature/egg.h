@@ -4,23 +4,51 @@
 #include "entity/creature/creature.h"
 #include "entity/creature/mutable.h"
 #include "neat/genome.h"
-#include "entity/movable_entity.h"
+#include "entity/entity.h"
 
-class Egg : virtual public AliveEntity, virtual public MovableEntity {
+/*!
+ * @class Egg
+ *
+ * @brief An offspring incubating on the map.
+ *
+ * @details An egg only carries what hatching needs: a handle on the genome,
+ * the mutables, the incubation clock and its nutritional value. Unlike
+ * creatures it has no brain, the neural network is compiled once, when the
+ * hatchling is created.
+ */
+class Egg : virtual public Entity {
  public:
   Egg(const GestatingEgg& gestating_egg,
       const std::pair<double, double>& coordinates);
 
   double GetIncubationTime() const;
 
+  double GetAge() const { return age_; }
+  void SetAge(double age) { age_ = age; }
+  double GetHealth() const { return health_; }
+  void SetHealth(double health) { health_ = health; }
+  int GetGeneration() const { return generation_; }
+
+  const neat::Genome& GetGenome() const { return *genome_; }
+  std::shared_ptr<const neat::Genome> GetSharedGenome() const {
+    return genome_;
+  }
+  std::size_t GetGenomeHash() const { return genome_hash_; }
+  const Mutable& GetMutable() const { return mutable_; }
+
   void Break();
   std::shared_ptr<Creature> Hatch();
   void Update(double delta_time);
   double GetNutritionalValue(){ return nutritional_value_; }
   void SetNutritionalValue(double value) { nutritional_value_ = value; }
-  bool CompatibleWithCreature(neat::Genome genome, Mutable mutables);
+  bool CompatibleWithCreature(const AliveEntity& creature) const;
 
  protected:
+  std::shared_ptr<const neat::Genome> genome_; /*!< Shared with the parent. */
+  std::size_t genome_hash_; /*!< Cached genome_->GetHash(). */
+  Mutable mutable_;
+  double age_;
+  double health_;
   int generation_;
   double incubation_time_;
   double nutritional_value_;
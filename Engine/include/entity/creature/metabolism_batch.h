@@ -0,0 +1,57 @@
+#ifndef METABOLISM_BATCH_H
+#define METABOLISM_BATCH_H
+
+#include <vector>
+
+/*!
+ * @file metabolism_batch.h
+ *
+ * @brief Runs the metabolism of many creatures at once.
+ */
+
+class Creature;
+
+/*!
+ * @class MetabolismBatch
+ *
+ * @brief Creature::UpdateMetabolism for many creatures as one vectorised
+ * kernel.
+ *
+ * @details Digestion, growth, stomach acid, mating desire, the reproductive
+ * clocks, aging, the energy balance and the eating cooldown only touch a
+ * handful of scalars of each creature. They are gathered into one array per
+ * quantity, updated by a single branch-free pass and scattered back. The
+ * random numbers the mating desire needs are drawn serially on the calling
+ * thread at the start of Step, one per creature in queue order, before the
+ * kernel runs. Every creature is queued, dead ones included, so the death mask filled by Step is
+ * aligned with the queue: it flags the creatures dead before the step and
+ * those which died during it.
+ */
+class MetabolismBatch {
+ public:
+  void Clear();
+  void Add(Creature &creature);
+  void Step(double delta_time);
+
+  int GetSize() const;
+  const std::vector<char> &GetDeaths() const;
+
+ private:
+  std::vector<Creature *> creatures_; /*!< Creatures queued. */
+
+  // state, one slot per creature
+  std::vector<double> energy_, health_, size_, age_;
+  std::vector<double> acid_, fullness_, stomach_energy_, capacity_, bite_;
+  std::vector<double> cooldown_, egg_age_;
+  // inputs
+  std::vector<double> max_energy_, ready_at_, maturity_, effort_, hardship_;
+  std::vector<double> random_;
+  std::vector<double> integrity_, growth_factor_, max_size_, stomach_factor_,
+      strength_, energy_loss_, energy_density_;
+  std::vector<char> alive_, pregnant_;
+  // outputs
+  std::vector<char> desire_;
+  std::vector<char> deaths_; /*!< Dead after the step, per creature. */
+};
+
+#endif  // METABOLISM_BATCH_H
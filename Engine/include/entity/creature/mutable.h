@@ -47,29 +47,33 @@ class Mutable {
   double CompatibilityBetweenMutables(const Mutable& other_mutable) const;
 
  private:
-  // Any values added here need to be included in the complexity, mutation, and
-  // crossover functions
-  double energy_density_;
-  double energy_loss_;
-  double integrity_;
-  double strafing_difficulty_;  // value in movable entity so we'll need to
-                                // treat it a lil bit different
-  double max_size_;
-  double baby_size_;
-  double max_force_;
-  double growth_factor_; /*!< Determines how the creature grows in relation to
-                            energy intake. */
-  double vision_factor_;
+  // Any values added here need to be included in the complexity, mutation,
+  // crossover and compatibility functions
+  enum Trait {
+    kEnergyDensity,
+    kEnergyLoss,
+    kIntegrity,
+    kStrafingDifficulty,  // value in movable entity so we'll need to treat it
+                          // a lil bit different
+    kMaxSize,
+    kBabySize,
+    kMaxForce,
+    kGrowthFactor,  /*!< Determines how the creature grows in relation to
+                       energy intake. */
+    kVisionFactor,
+    kGestationRatioToIncubation,
+    kStomachCapacityFactor, /*!< Determines the stomach capacity in relation
+                               to its size. */
+    kDiet,             /*!< Determines whether a creature is herbivore or
+                          carnivore */
+    kGeneticStrength,  /*! Determines bite stength */
+    kEatingSpeed,      /*! Determines eating and digestion cooldown */
+    kPheromoneEmission, /*! Determines the rate of pheromone emission */
+    kTraitCount
+  };
 
-  float color_;
-  double stomach_capacity_factor_; /*!< Determines the stomach capacity in
-                            relation to its size. */
-  double diet_; /*!< Determines whether a creature is herbivore or carnivore */
-  double genetic_strength_; /*! Determines bite stength */
-  double eating_speed_; /*! Determines eating and digestion cooldown */
-
-  double pheromone_emission_;/*! Determines the rate of pheromone emission */
-  double gestation_ratio_to_incubation_;
+  double traits_[kTraitCount]; /*!< Packed numeric traits. */
+  float color_; /*!< Hue, kept as float as shaders use floats. */
 };
 
 Mutable MutableCrossover(const Mutable& dominant, const Mutable& recessive);
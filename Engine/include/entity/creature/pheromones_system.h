@@ -4,26 +4,39 @@
 #include <vector>
 #include <memory>
 
+#include "core/scratch_arena.h"
 #include "entity/alive_entity.h"
 #include "entity/creature/pheromone.h"
 
 class PheromoneSystem : virtual public AliveEntity
 {
 public:
-    PheromoneSystem(neat::Genome gemone, Mutable mutables);
+    PheromoneSystem(const neat::Genome& genome, const Mutable& mutables);
 
     void ProcessPheromoneDetection(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                                    double GridCellSize);
 
-    std::vector<double> GetPheromoneDensities(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+    ScratchVector<double> GetPheromoneDensities(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                                               double GridCellSize) const ;
 
-    std::vector<std::shared_ptr<Pheromone>> EmitPheromones(double deltaTime);
+    int DrawPheromones(double deltaTime);
+    ScratchVector<std::shared_ptr<Pheromone>> EmitPheromones();
 
 protected:
+    /*!
+     * @brief A pheromone drawn by DrawPheromones, not created yet.
+     */
+    struct PendingPheromone {
+        int type;
+        double x_coord;
+        double y_coord;
+        double size;
+    };
+
     std::vector<int> pheromone_types_;
     std::vector<double> pheromone_densities_;
     std::vector<double> pheromone_emissions_;
+    std::vector<PendingPheromone> pending_pheromones_;
 };
 
 #endif
@@ -14,7 +14,7 @@ class Egg;
 
 class ReproductiveSystem : virtual public AliveEntity {
  public:
-  ReproductiveSystem(neat::Genome genome, Mutable mutables);
+  ReproductiveSystem(const neat::Genome& genome, const Mutable& mutables);
   virtual ~ReproductiveSystem() = default;
 
   virtual bool IsMale() const { return false; };
@@ -49,7 +49,7 @@ class ReproductiveSystem : virtual public AliveEntity {
 
 class MaleReproductiveSystem : virtual public ReproductiveSystem {
  public:
-  MaleReproductiveSystem(neat::Genome genome, Mutable mutables);
+  MaleReproductiveSystem(const neat::Genome& genome, const Mutable& mutables);
 
   bool IsMale() const override { return true; }
   void MateWithFemale();
@@ -58,18 +58,21 @@ class MaleReproductiveSystem : virtual public ReproductiveSystem {
 
 class GestatingEgg {
 public:
-  neat::Genome genome;
+  std::shared_ptr<const neat::Genome> genome;
   Mutable mutables;
   int generation;
   double age;
   double incubation_time;
 
-  GestatingEgg(neat::Genome genome, Mutable mutables, int generation);
+  GestatingEgg(std::shared_ptr<const neat::Genome> genome,
+               const Mutable& mutables, int generation);
 };
 
+GestatingEgg Conceive(const Creature& father, const Creature& mother);
+
 class FemaleReproductiveSystem : virtual public ReproductiveSystem {
  public:
-  FemaleReproductiveSystem(neat::Genome genome, Mutable mutables);
+  FemaleReproductiveSystem(const neat::Genome& genome, const Mutable& mutables);
 
   bool IsFemale() const override { return true; }
   bool IsPregnant() const  { return egg_.has_value(); };
@@ -78,6 +81,7 @@ class FemaleReproductiveSystem : virtual public ReproductiveSystem {
 
   virtual void Update(double delta_time) override;
   void MateWithMale(const std::shared_ptr<Creature> father, const std::shared_ptr<Creature> mother);
+  void MateWithMale(GestatingEgg egg);
   bool CanBirth() const;
   std::shared_ptr<Egg> GiveBirth(const std::pair<double, double>& coordinates);
 
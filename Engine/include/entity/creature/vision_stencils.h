@@ -0,0 +1,59 @@
+#ifndef VISION_STENCILS_H
+#define VISION_STENCILS_H
+
+#include <vector>
+
+/*!
+ * @file vision_stencils.h
+ *
+ * @brief Precomputed sets of grid cells a vision cone can reach.
+ */
+
+/*!
+ * @struct StencilCell
+ *
+ * @brief A grid cell, relative to the cell of the viewer.
+ */
+struct StencilCell {
+  int dx; /*!< Offset in columns. */
+  int dy; /*!< Offset in rows. */
+  double min_distance; /*!< Lower bound, in cells, of the distance from the
+                          viewer to an entity centred in the cell. */
+};
+
+using Stencil = std::vector<StencilCell>;
+
+/*!
+ * @class VisionStencils
+ *
+ * @brief The cells a vision cone may see, for every orientation bucket.
+ *
+ * @details Distances are in grid cells. The radius, angle and margin are
+ * rounded up to a coarse lattice and the orientation is split in
+ * kOrientationBuckets buckets, with the cone widened by half a bucket, so
+ * each stencil is a superset of the cells any cone of its bucket can reach
+ * from anywhere in the viewer's cell. The margin accounts for the size of the
+ * entities seen. Cells are sorted by increasing min_distance, which lets a
+ * nearest-entities search stop early.
+ *
+ * Stencil sets are built once per quantised (radius, angle, margin) and
+ * shared by every creature, they are never freed.
+ */
+class VisionStencils {
+ public:
+  static constexpr int kOrientationBuckets = 64;
+
+  static const VisionStencils& Get(double radius, double angle,
+                                   double margin);
+
+  const Stencil& ForOrientation(double orientation) const;
+  bool MayWrap(int columns, int rows) const;
+
+ private:
+  VisionStencils(int radius_steps, int angle_steps, int margin_steps);
+
+  std::vector<Stencil> stencils_; /*!< Indexed by orientation bucket. */
+  int reach_; /*!< Largest |dx| or |dy| of the stencils. */
+};
+
+#endif  // VISION_STENCILS_H
@@ -1,14 +1,22 @@
 #ifndef VISIONSYSTEM_H
 #define VISIONSYSTEM_H
 
+#include <array>
+#include <cstdint>
 #include <memory>
 
+#include "core/geometry_primitives.h"
+#include "core/scratch_arena.h"
 #include "entity/alive_entity.h"
+#include "entity/creature/vision_stencils.h"
 #include "entity/food.h"
 
 class VisionSystem : virtual public AliveEntity {
 public:
-  VisionSystem(neat::Genome genome, Mutable mutables);
+  /*! @brief What a ray of the ray-cast vision module hit first. */
+  enum RayHit { kNothing, kPlant, kMeat, kCreature, kEgg };
+
+  VisionSystem(const neat::Genome& genome, const Mutable& mutables);
   virtual ~VisionSystem() override {}
 
   void SetVision(double radius, double angle);
@@ -21,10 +29,54 @@ public:
   bool IsInRightDirection(std::shared_ptr<Entity> entity, double map_width, double map_heigth);
   bool IsInVisionCone(std::shared_ptr<Entity> entity, double map_width, double map_heigth) const;
 
-  std::vector<std::shared_ptr<Entity>> GetClosestEntitiesInSight(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+  ScratchVector<std::shared_ptr<Entity>> GetClosestEntitiesInSight(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                                               double grid_cell_size, double map_width, double map_heigth) const;
+  void CastRays(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+                double grid_cell_size, double map_width, double map_heigth,
+                int rays, double* out) const;
 
 protected:
+  /*!
+   * @struct Cone
+   * @brief The vision cone, computed once per query.
+   */
+  struct Cone {
+    Point center;
+    OrientedAngle left_boundary;
+    OrientedAngle right_boundary;
+  };
+
+  /*!
+   * @struct ScannedCell
+   * @brief A cell scanned by GetClosestEntitiesInSight and the entities it
+   * held then.
+   */
+  struct ScannedCell {
+    int x, y;
+    std::uint64_t signature; /*!< Of the ids in the cell, see CellSignature. */
+  };
+
+  /*!
+   * @struct VisionCache
+   * @brief The last answer of GetClosestEntitiesInSight and what it scanned.
+   *
+   * @details The entities are held weakly, the cache must not keep dead ones
+   * alive.
+   */
+  struct VisionCache {
+    bool valid = false;
+    std::vector<std::weak_ptr<Entity>> entities; /*!< Entities found. */
+    std::vector<ScannedCell> cells; /*!< Cells scanned. */
+    int stencil_end = 0; /*!< Stencil cells scanned. */
+    const Stencil* stencil = nullptr; /*!< Stencil used. */
+    int x_grid = 0, y_grid = 0; /*!< Cell of the creature. */
+    double x = 0, y = 0; /*!< Position at the last full scan. */
+    int age = 0; /*!< Queries since the last full scan. */
+  };
+
+  Cone GetVisionCone() const;
+  bool IsInVisionCone(const Cone& cone, const Entity& entity, double map_width, double map_heigth) const;
+
   double distance_entity_;       /*!< Distance to the nearest entity */
   double orientation_entity_;   /*!< Orientation relative to the nearest entity */
   double entity_compatibility_; /*! Compatibility with closest entity*/
@@ -38,6 +90,10 @@ protected:
                             the field of view. */
 
   int number_entities_to_return_; /*!< Number of entities in sight to return when processing vision */
+
+  mutable const VisionStencils* stencils_ = nullptr; /*!< Stencils of the cone. */
+  mutable std::array<double, 3> stencil_key_{}; /*!< Radius, angle and cell size of stencils_. */
+  mutable VisionCache vision_cache_; /*!< Reused between thinks. */
 };
 
 double GetRandomFloat(double min_value, double max_value);
@@ -1,6 +1,7 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -52,7 +53,7 @@ class Entity {
   }
   double GetRelativeOrientation(const std::shared_ptr<Entity> otherEntity) const;
 
-  int GetID() const;
+  std::int64_t GetID() const;
 
   float GetColor() const;
   void SetColor(float value);
@@ -63,8 +64,7 @@ class Entity {
   float color_hue_;
 
  private:
-  static int next_id_;
-  int id_;
+  std::int64_t id_; /*!< Unique id, from IdService. */
 };
 
 double GetRandomFloat(double max);
@@ -0,0 +1,55 @@
+#ifndef LOCOMOTION_BATCH_H
+#define LOCOMOTION_BATCH_H
+
+#include <vector>
+
+#include "entity/movable_entity.h"
+
+/*!
+ * @file locomotion_batch.h
+ *
+ * @brief Integrates the motion of many entities at once.
+ */
+
+/*!
+ * @class LocomotionBatch
+ *
+ * @brief Runs MovableEntity::UpdateVelocities, Move and Rotate for many
+ * entities as one vectorised kernel.
+ *
+ * @details Entities are queued, their motion state is gathered into one array
+ * per quantity, the kernel applies the forward and rotational friction,
+ * integrates the velocities, the positions with toroidal wrap and the
+ * orientations in SIMD lanes, and the results are scattered back. The state is
+ * read directly from the entities, not through their virtual getters, so
+ * entities overriding the motion model (GrabbingEntity) must not be queued.
+ *
+ * The batch double-buffers the motion state: Integrate only reads the
+ * entities and leaves the next state in the batch, Swap publishes it. Between
+ * the two the entities keep the state of the last tick, which the other
+ * entities can read without racing with the integration.
+ */
+class LocomotionBatch {
+ public:
+  void Clear();
+  void Add(MovableEntity &entity);
+  void Integrate(double delta_time, double map_width, double map_height);
+  void Swap();
+  void Step(double delta_time, double map_width, double map_height);
+
+  int GetSize() const;
+
+ private:
+  std::vector<MovableEntity *> entities_; /*!< Entities queued. */
+
+  // one slot per entity, holding the next state after Integrate
+  std::vector<double> x_, y_, orientation_;
+  std::vector<double> velocity_x_, velocity_y_, rotational_velocity_;
+  std::vector<double> acceleration_, acceleration_angle_;
+  std::vector<double> rotational_acceleration_;
+  std::vector<double> friction_; /*!< Forward friction per unit velocity. */
+  std::vector<double> strafing_; /*!< Strafing difficulty. */
+  std::vector<double> rotational_friction_; /*!< Per unit rotational velocity. */
+};
+
+#endif  // LOCOMOTION_BATCH_H
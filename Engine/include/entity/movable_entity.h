@@ -3,6 +3,17 @@
 
 #include "entity/entity.h"
 
+/*!
+ * @class MovableEntity
+ *
+ * @brief An entity with linear and rotational motion.
+ *
+ * @details The velocity is stored in Cartesian form in the frame of the
+ * entity: velocity_x_ along its orientation and velocity_y_ to its left, so it
+ * turns with the entity. The polar velocity and velocity angle are derived on
+ * demand. LocomotionBatch integrates many entities at once with the same
+ * model as UpdateVelocities, Move and Rotate.
+ */
 class MovableEntity : virtual public Entity {
  public:
   MovableEntity();
@@ -40,8 +51,11 @@ class MovableEntity : virtual public Entity {
   virtual void OnCollision(std::shared_ptr<Entity> other_entity, double const kMapWidth,
                            double const kMapHeight) override;
  protected:
+  friend class LocomotionBatch;
+
   double acceleration_, acceleration_angle_, rotational_acceleration_;
-  double velocity_, velocity_angle_, rotational_velocity_;
+  double velocity_x_, velocity_y_; /*!< Velocity in the entity's frame. */
+  double rotational_velocity_;
   double strafing_difficulty_;
   double frictional_coefficient_;
 };
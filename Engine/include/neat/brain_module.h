@@ -1,13 +1,14 @@
 #ifndef BRAINMODULE_H
 #define BRAINMODULE_H
 
+#include <cstdint>
 #include <vector>
 
 class BrainModule
 {
 public:
     BrainModule(int input, int output, int module_id, bool multiple = false);
-    BrainModule(int first_input_index, int first_output_index, const std::vector<int>& input_neuron_ids, const std::vector<int>& output_neurons_ids, int module_id, bool multiple, int type);
+    BrainModule(int first_input_index, int first_output_index, const std::vector<std::int64_t>& input_neuron_ids, const std::vector<std::int64_t>& output_neurons_ids, int module_id, bool multiple, int type);
 
     int GetFirstInputIndex() const;
     void SetFirstInputIndex(const int index);
@@ -15,11 +16,11 @@ public:
     int GetFirstOutputIndex() const;
     void SetFirstOutputIndex(const int index);
 
-    std::vector<int> GetInputNeuronIds() const;
-    void SetInputNeuronIds(const std::vector<int> input_neuron_ids);
+    std::vector<std::int64_t> GetInputNeuronIds() const;
+    void SetInputNeuronIds(const std::vector<std::int64_t> input_neuron_ids);
 
-    std::vector<int> GetOutputNeuronIds() const;
-    void SetOutputNeuronIds(const std::vector<int> input_neuron_ids);
+    std::vector<std::int64_t> GetOutputNeuronIds() const;
+    void SetOutputNeuronIds(const std::vector<std::int64_t> input_neuron_ids);
 
     int GetModuleId() const;
 
@@ -31,8 +32,8 @@ public:
 private:
     int first_input_index_;
     int first_output_index_;
-    std::vector<int> input_neuron_ids_;
-    std::vector<int> output_neuron_ids_;
+    std::vector<std::int64_t> input_neuron_ids_;
+    std::vector<std::int64_t> output_neuron_ids_;
 
     int module_id_; /*! Unique identifier for a type of module */
     bool multiple_; /*! Boolean that indicates if multiple instances of
@@ -0,0 +1,94 @@
+#ifndef NEATCOMPATIBILITYCACHE_H
+#define NEATCOMPATIBILITYCACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "neat/genome.h"
+
+namespace neat {
+
+/*!
+ * @class CompatibilityCache
+ *
+ * @brief Bounded memo of Genome::CompatibilityBetweenGenomes results.
+ *
+ * @details Genomes never change once a creature is born, so the distance
+ * between two of them is fixed. Entries are found by the unordered pair of
+ * Genome::GetHash values, which callers compute once and keep, and confirmed
+ * with the genomes themselves: a slot holds weak references to its pair and
+ * only serves the same genomes, or equal ones, so two pairs whose hashes
+ * collide never share a distance. The table is
+ * split into shards, each with its own lock and a clock (second chance)
+ * eviction over a fixed number of slots, sized by
+ * SETTINGS.compatibility.compatibility_cache_size. A size of zero disables
+ * the cache. Safe to use from several threads.
+ */
+class CompatibilityCache {
+ public:
+  // Singleton access method
+  static CompatibilityCache &GetInstance() {
+    static CompatibilityCache instance;
+    return instance;
+  }
+
+  CompatibilityCache(const CompatibilityCache &) = delete;
+  CompatibilityCache &operator=(const CompatibilityCache &) = delete;
+
+  double Distance(const std::shared_ptr<const Genome> &a, std::size_t hash_a,
+                  const std::shared_ptr<const Genome> &b, std::size_t hash_b);
+  void Clear();
+
+  int GetSize();
+  long GetHits() const;
+  long GetMisses() const;
+  double GetHitRate() const;
+
+ private:
+  CompatibilityCache() = default;
+
+  static constexpr int kShards = 16;
+
+  struct Key {
+    std::size_t first;  /*!< Smaller of the two genome hashes. */
+    std::size_t second; /*!< Larger of the two genome hashes. */
+    bool operator==(const Key &other) const {
+      return first == other.first && second == other.second;
+    }
+  };
+
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const;
+  };
+
+  struct Slot {
+    Key key;                             /*!< Pair stored in the slot. */
+    std::weak_ptr<const Genome> first;   /*!< Genome hashed to key.first. */
+    std::weak_ptr<const Genome> second;  /*!< Genome hashed to key.second. */
+    double distance;                     /*!< Memoised distance. */
+    bool referenced = false;             /*!< Clock bit, set on every hit. */
+
+    bool Holds(const Genome &a, const Genome &b) const;
+  };
+
+  struct Shard {
+    std::mutex mutex; /*!< Guards the members below. */
+    std::unordered_map<Key, int, KeyHash> index; /*!< Key to slot. */
+    std::vector<Slot> slots;                     /*!< Clock ring. */
+    int hand = 0;                                /*!< Clock hand. */
+  };
+
+  Shard &ShardOf(std::size_t key_hash);
+  void Insert(Shard &shard, Slot slot, std::size_t capacity);
+
+  Shard shards_[kShards];       /*!< Independently locked parts. */
+  std::atomic<long> hits_{0};   /*!< Lookups served from the cache. */
+  std::atomic<long> misses_{0}; /*!< Lookups which computed a distance. */
+};
+
+}  // end of namespace neat
+
+#endif  // NEATCOMPATIBILITYCACHE_H
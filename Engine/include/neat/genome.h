@@ -1,6 +1,8 @@
 #ifndef NEATGENOME_H
 #define NEATGENOME_H
 
+#include <cstdint>
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
@@ -16,7 +18,13 @@ namespace neat {
  * @brief Represents a genetic encoding of a neural network for use in NEAT.
  *
  * @details The Genome class contains neurons and links representing the
- * topology and weights of a neural network.
+ * topology and weights of a neural network. Neurons and links are kept sorted
+ * by id (their innovation number), so that two genomes can be aligned with a
+ * single merge pass. Alongside them the Genome keeps per-type lists of neuron
+ * ids and the adjacency of every neuron, together with a topological order of
+ * the non-cyclic links that is repaired incrementally as links are added, so
+ * structural mutations cost time proportional to the part of the graph they
+ * affect.
  */
   class Genome {
    public:
@@ -26,7 +34,7 @@ namespace neat {
     int GetOutputCount() const;
     const std::vector<Neuron>& GetNeurons() const;
     const std::vector<Link>& GetLinks() const;
-    std::vector<BrainModule> GetModules() const;
+    const std::vector<BrainModule>& GetModules() const;
     std::vector<BrainModule> GetAvailableModules() const;
 
     void AddNeuron(const Neuron& neuron);
@@ -34,15 +42,17 @@ namespace neat {
     void SetModules(const std::vector<BrainModule>& modules);
     void SetAvailableModules(const std::vector<BrainModule>& modules);
 
-    void DisableNeuron(int id);  // don't use this for now
-    void DisableLink(int id);
-    void EnableNeuron(int id);  // don't use this for now
-    void EnableLink(int id);
-    void RemoveNeuron(int id);
-    void RemoveLink(int id);
+    void DisableNeuron(std::int64_t id);  // don't use this for now
+    void DisableLink(std::int64_t id);
+    void EnableNeuron(std::int64_t id);  // don't use this for now
+    void EnableLink(std::int64_t id);
+    void RemoveNeuron(std::int64_t id);
+    void RemoveLink(std::int64_t id);
 
 
     void Mutate();
+    int MaxNeuronsPerMutation() const;
+    static constexpr int kMaxLinksPerMutation = 3; /*!< Split link and new. */
 
     void MutateAddNeuron();
     void MutateAddLink();
@@ -54,26 +64,57 @@ namespace neat {
     void MutateActivateBrainModule();
     void MutateDisableBrainModule();
 
-    bool FindNeuronById(int targetId, Neuron& foundNeuron) const;
+    bool FindNeuronById(std::int64_t targetId, Neuron& foundNeuron) const;
 
     bool DetectLoops(const Neuron& n);
 
-    bool HasLink(const int& in_id, const int& ou_id);
+    bool HasLink(std::int64_t in_id, std::int64_t ou_id);
+
+    bool CreatesCycle(std::int64_t in_id, std::int64_t out_id) const;
 
     double CompatibilityBetweenGenomes(const Genome& other) const;
 
+    std::size_t GetHash() const;
+    bool operator==(const Genome& other) const;
+
    private:
     std::vector<Neuron> neurons_; /*!< A vector of Neuron objects representing the
                                      neurons in the Genome. */
     std::vector<Link> links_;     /*!< A vector of Link objects representing the
                                      connections between neurons in the Genome.
                                       */
-    bool DFS(const Neuron& currentNeuron, std::unordered_set<int>& visited,
-             std::unordered_set<int>& visiting) const;
+    /*!
+     * @brief Links of a neuron, stored at the neuron's index in neurons_.
+     */
+    struct Adjacency {
+      std::vector<std::int64_t> successors; /*!< Out ids, non-cyclic links. */
+      std::vector<std::int64_t> predecessors; /*!< In ids, non-cyclic links. */
+      std::vector<std::int64_t> cyclic_successors; /*!< Out ids, cyclic links. */
+      int order = 0; /*!< Rank in a topological order of non-cyclic links. */
+    };
+    std::vector<Adjacency> adjacency_; /*!< Aligned with neurons_. */
+    std::vector<std::int64_t> input_ids_;  /*!< Ids of the input neurons. */
+    std::vector<std::int64_t> hidden_ids_; /*!< Ids of the hidden neurons. */
+    std::vector<std::int64_t> output_ids_; /*!< Ids of the output neurons. */
+    int next_order_ = 0; /*!< Rank given to the next neuron. */
+
+    bool DFS(const Neuron& currentNeuron,
+             std::unordered_set<std::int64_t>& visited,
+             std::unordered_set<std::int64_t>& visiting) const;
+    int NeuronIndex(std::int64_t id) const;
+    int LinkIndex(std::int64_t id) const;
+    std::vector<std::int64_t>& IdsOfType(NeuronType type);
+    bool Reaches(int from_index, int to_index, int max_order,
+                 std::vector<int>* reached) const;
+    bool InsertInOrder(int in_index, int out_index);
+    void IndexLink(const Link& link);
+    void UnindexLink(const Link& link);
     std::vector<BrainModule> modules_; /*! A vector of BrainModule objects
                                          representing the modules activated. */
 
-    std::vector<BrainModule> AvailableModules = {BrainModule(3, 0, 1), BrainModule(1, 1, 2, true), BrainModule(5, 0, 3, true)}; //Geolocation, Pheromone, Vision Module
+    static std::vector<BrainModule> DefaultModules();
+
+    std::vector<BrainModule> AvailableModules = DefaultModules(); //Geolocation, Pheromone, Vision, Ray vision Module
     //To add more modules you also have to change the think function of the creature. //
 
   };
@@ -1,6 +1,8 @@
 #ifndef NEATLINK_H
 #define NEATLINK_H
 
+#include <cstdint>
+
 namespace neat {
 
 /*!
@@ -13,13 +15,13 @@ namespace neat {
  */
 class Link {
  public:
-  explicit Link(int in_id, int out_id, double weight);
-  explicit Link(int id, int in_id, int out_id, double weight, bool active,
-                bool cyclic);
+  explicit Link(std::int64_t in_id, std::int64_t out_id, double weight);
+  explicit Link(std::int64_t id, std::int64_t in_id, std::int64_t out_id,
+                double weight, bool active, bool cyclic);
 
-  int GetId() const;
-  int GetInId() const;
-  int GetOutId() const;
+  std::int64_t GetId() const;
+  std::int64_t GetInId() const;
+  std::int64_t GetOutId() const;
   double GetWeight() const;
   bool IsActive() const;
   bool IsCyclic() const;
@@ -31,11 +33,9 @@ class Link {
   void SetNonCyclic();
 
  private:
-  static int
-      next_id_; /*!< Static variable used to assign unique IDs to new links. */
-  int id_;      /*!< Unique identifier for the link. */
-  int in_id_;   /*!< ID of the input neuron. */
-  int out_id_;  /*!< ID of the output neuron. */
+  std::int64_t id_;     /*!< Unique identifier for the link. */
+  std::int64_t in_id_;  /*!< ID of the input neuron. */
+  std::int64_t out_id_; /*!< ID of the output neuron. */
   double weight_; /*!< Weight of the connection. */
   bool active_;   /*!< Indicates whether the link is active or not. */
   bool cyclic_;   /*!< Indicates whether the link introduces a cycle or not. */
@@ -0,0 +1,68 @@
+#ifndef NEATNETWORKCACHE_H
+#define NEATNETWORKCACHE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "neat/neural_network.h"
+
+namespace neat {
+
+/*!
+ * @class NetworkCache
+ *
+ * @brief Shares one CompiledNetwork between all brains built from identical
+ * genomes.
+ *
+ * @details Entries are keyed by Genome::GetHash and confirmed with a full
+ * genome comparison. The cache only holds weak references: a compiled network
+ * lives as long as some NeuralNetwork uses it, and expired entries are swept
+ * as the table grows. Recurrent state is not shared, it stays in each
+ * NeuralNetwork. Safe to use from several threads.
+ */
+class NetworkCache {
+ public:
+  // Singleton access method
+  static NetworkCache &GetInstance() {
+    static NetworkCache instance;
+    return instance;
+  }
+
+  NetworkCache(const NetworkCache &) = delete;
+  NetworkCache &operator=(const NetworkCache &) = delete;
+
+  std::shared_ptr<const CompiledNetwork> Get(const Genome &genom);
+  std::shared_ptr<const CompiledNetwork> Get(
+      std::shared_ptr<const Genome> genom);
+
+  int GetSize();
+  long GetHits() const;
+  long GetMisses() const;
+
+ private:
+  NetworkCache() = default;
+
+  struct Entry {
+    std::shared_ptr<const Genome> genome;            /*!< Key, for equality. */
+    std::shared_ptr<const CompiledNetwork> network;  /*!< Compiled network. */
+  };
+
+  std::shared_ptr<const CompiledNetwork> GetOrCompile(
+      const Genome &genom, std::shared_ptr<const Genome> shared);
+  std::shared_ptr<const CompiledNetwork> Find(std::size_t hash,
+                                              const Genome &genom);
+  void SweepExpired();
+
+  std::mutex mutex_; /*!< Guards entries_ and the sweep threshold. */
+  std::unordered_multimap<std::size_t, std::weak_ptr<const Entry> >
+      entries_;                  /*!< Live and expired entries by hash. */
+  std::size_t sweep_at_ = 1024;  /*!< Table size triggering the next sweep. */
+  std::atomic<long> hits_{0};    /*!< Lookups served from the cache. */
+  std::atomic<long> misses_{0};  /*!< Lookups which compiled a network. */
+};
+
+}  // end of namespace neat
+
+#endif  // NEATNETWORKCACHE_H
@@ -1,10 +1,27 @@
 #ifndef NEATNEURALNETWORK_H
 #define NEATNEURALNETWORK_H
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "neat/genome.h"
 
 namespace neat {
 
+/*!
+ * @enum Precision
+ *
+ * @brief Arithmetic used to activate a network.
+ *
+ * @details kFloat evaluates in single precision. kInt8 also evaluates in
+ * single precision but reads weights quantised to 8 bits with one scale per
+ * neuron. Recurrent state and the values returned stay double in every mode.
+ */
+enum class Precision { kDouble, kFloat, kInt8 };
+
+Precision ParsePrecision(const std::string &name);
+
 /*!
  * @struct NeuronInput
  *
@@ -15,7 +32,7 @@ namespace neat {
  * connection.
  */
 struct NeuronInput {
-  int input_id;  /*!< The ID of the input neuron. */
+  std::int64_t input_id; /*!< The ID of the input neuron. */
   double weight; /*!< The weight of the connection from the input neuron. */
 };
 
@@ -30,7 +47,7 @@ struct NeuronInput {
  */
 struct FeedForwardNeuron {  // Functional units of the NeuralNetowork, obtained
                             // from Neurons and Links
-  int id;                   /*!< The ID of the neuron. */
+  std::int64_t id;          /*!< The ID of the neuron. */
   double bias;              /*!< The bias of the neuron. */
   double value; /*!< The value of the neuron. Important for the neurons which
                    start a cycle.*/
@@ -44,25 +61,103 @@ struct FeedForwardNeuron {  // Functional units of the NeuralNetowork, obtained
   ActivationType activation; /*! Activation function of the neuron. */
 };
 
+/*!
+ * @struct ActivationGroup
+ *
+ * @brief A run of consecutive compiled neurons sharing one activation
+ * function.
+ *
+ * @details Groups never span two layers, so every neuron of a group can be
+ * evaluated before the activation is applied to the whole run at once.
+ */
+struct ActivationGroup {
+  int begin;                 /*!< First dense index of the group. */
+  int end;                   /*!< One past the last dense index of the group. */
+  ActivationType activation; /*!< Activation applied to the whole group. */
+};
+
+/*!
+ * @struct CompiledNetwork
+ *
+ * @brief Immutable, topologically ordered flat-array form of a Genome.
+ *
+ * @details Neuron ids are remapped to dense indices: the inputs occupy
+ * [0, input_count), the hidden neurons follow in layer order and the outputs
+ * occupy the last output_count slots. Incoming connections are stored in CSR
+ * form, with row i spanning [offsets[i], offsets[i + 1]) of the source and
+ * weight arrays. Recurrent connections live in a second CSR block and only
+ * feed the per-network state after each activation.
+ */
+struct CompiledNetwork {
+  int input_count = 0;  /*!< Number of input neurons. */
+  int output_count = 0; /*!< Number of output neurons. */
+
+  std::vector<std::int64_t> ids; /*!< Neuron id of every dense index. */
+  std::vector<double> bias; /*!< Bias of every dense index. */
+  std::vector<ActivationType>
+      activations; /*!< Activation declared by the genome for every index. */
+
+  std::vector<int> input_offsets;    /*!< CSR row pointers, size() + 1. */
+  std::vector<int> input_sources;    /*!< Dense index of each input. */
+  std::vector<double> input_weights; /*!< Weight of each input. */
+
+  std::vector<int> cycle_offsets;    /*!< CSR row pointers, size() + 1. */
+  std::vector<int> cycle_sources;    /*!< Dense index of each cyclic input. */
+  std::vector<double> cycle_weights; /*!< Weight of each cyclic input. */
+
+  std::vector<ActivationGroup> groups; /*!< Evaluation schedule. */
+
+  std::vector<float> bias_f;          /*!< bias in single precision. */
+  std::vector<float> input_weights_f; /*!< input_weights in single precision. */
+  std::vector<std::int8_t>
+      input_weights_q;            /*!< input_weights quantised per row. */
+  std::vector<float> row_scales; /*!< Weight of a quantised step, per row. */
+
+  std::size_t shape_hash = 0; /*!< Hash of everything but weights and biases. */
+
+  int size() const { return static_cast<int>(ids.size()); }
+};
+
+std::shared_ptr<const CompiledNetwork> CompileNetwork(const Genome &genom);
+
+bool SameShape(const CompiledNetwork &a, const CompiledNetwork &b);
+
 /*!
  * @class NeuralNetwork
  *
  * @brief Represents a neural network constructed from a NEAT genome.
  *
- * @details This class translates a Genome into a feed-forward neural network
- * structure.
+ * @details This class pairs a CompiledNetwork with the state that belongs to a
+ * single brain: the values carried by recurrent connections and a scratch
+ * buffer for the activations, so repeated calls to Activate do not allocate.
  */
 class NeuralNetwork {
  public:
   NeuralNetwork(const Genome &genom);
+  NeuralNetwork(std::shared_ptr<const Genome> genom);
+  void Activate(const std::vector<double> &input_values,
+                std::vector<double> &output_values,
+                Precision precision = Precision::kDouble);
   std::vector<double> Activate(const std::vector<double> &input_values);
   std::vector<FeedForwardNeuron> GetNeurons() const;
 
+  int GetInputCount() const;
+  int GetOutputCount() const;
+  bool IsRecurrent() const;
+  std::shared_ptr<const CompiledNetwork> GetCompiled() const;
+
  private:
-  std::vector<int> input_ids_;  /*!< IDs of input neurons. */
-  std::vector<int> output_ids_; /*!< IDs of output neurons. */
-  std::vector<FeedForwardNeuron>
-      ffneurons_; /*!< Feed-forward neurons used in the network. */
+  friend class NeuralNetworkBatch;
+
+  void ActivateSingle(const std::vector<double> &input_values,
+                      std::vector<double> &output_values, bool quantised);
+
+  std::shared_ptr<const CompiledNetwork>
+      compiled_;              /*!< Topology, weights and schedule. */
+  std::vector<double> state_; /*!< Values fed back by recurrent links. */
+  std::vector<double> values_; /*!< Activations of the last call. */
+  std::vector<float> values_f_; /*!< Activations of the last reduced call,
+                                   sized on the first one. */
 };
 
 std::vector<std::vector<Neuron> > get_layers(
@@ -71,6 +166,10 @@ std::vector<std::vector<Neuron> > get_layers(
 
 double activation_function(ActivationType function, double x);
 
+void activation_function(ActivationType function, double *values, int count);
+
+void activation_function(ActivationType function, float *values, int count);
+
 }  // end of namespace neat
 
-#endif  // NEATNEURALNETWORK_H
\ No newline at end of file
+#endif  // NEATNEURALNETWORK_H
@@ -0,0 +1,80 @@
+#ifndef NEATNEURALNETWORKBATCH_H
+#define NEATNEURALNETWORKBATCH_H
+
+#include <vector>
+
+#include "neat/neural_network.h"
+
+namespace neat {
+
+/*!
+ * @class NeuralNetworkBatch
+ *
+ * @brief Activates many NeuralNetworks in one pass.
+ *
+ * @details Networks are queued with their input and output buffers, grouped
+ * by compiled shape and evaluated lane by lane: every neuron row holds one
+ * value per network, so the weighted sums and the activation functions run as
+ * SIMD loops across networks. Networks without a partner of the same shape
+ * fall back to the scalar NeuralNetwork::Activate.
+ *
+ * With a reduced Precision the lanes hold floats, twice as many networks per
+ * vector. In validation mode every network is also activated in double
+ * precision, with its recurrent state restored afterwards, and the largest
+ * and mean absolute differences of the outputs are recorded.
+ */
+class NeuralNetworkBatch {
+ public:
+  void Clear();
+  void Add(NeuralNetwork &network, const std::vector<double> &input_values,
+           std::vector<double> &output_values);
+  void Activate();
+
+  void SetPrecision(Precision precision);
+  void SetValidation(bool validate);
+  Precision GetPrecision() const;
+  int GetSize() const;
+  double GetMaxDrift() const;
+  double GetMeanDrift() const;
+
+ private:
+  struct Entry {
+    NeuralNetwork *network;
+    const std::vector<double> *input_values;
+    std::vector<double> *output_values;
+  };
+
+  template <typename T>
+  struct LaneBuffers {
+    std::vector<T> values;        /*!< values[neuron * lanes + lane] */
+    std::vector<T> state;         /*!< state[neuron * lanes + lane] */
+    std::vector<T> bias;          /*!< bias[neuron * lanes + lane] */
+    std::vector<T> weights;       /*!< weights[link * lanes + lane] */
+  };
+
+  struct Lanes {
+    LaneBuffers<double> wide;  /*!< Used by Precision::kDouble. */
+    LaneBuffers<float> narrow; /*!< Used by the reduced precisions. */
+  };
+
+  template <typename T>
+  void ActivateLanes(const Entry *const *entries, int lanes,
+                     LaneBuffers<T> &scratch);
+
+  std::vector<Entry> entries_; /*!< Networks queued since the last Clear. */
+  std::vector<const Entry *> order_; /*!< Entries sorted by shape. */
+  std::vector<std::pair<int, int> > runs_; /*!< Ranges of order_ that share
+                                              a shape. */
+  std::vector<Lanes> scratch_; /*!< Reused lane buffers, one per run. */
+
+  Precision precision_ = Precision::kDouble; /*!< Arithmetic of the lanes. */
+  bool validate_ = false; /*!< Whether to measure the drift from double. */
+  std::vector<std::vector<double> >
+      reference_; /*!< Double precision outputs, per entry, when validating. */
+  double max_drift_ = 0;  /*!< Largest output error of the last Activate. */
+  double mean_drift_ = 0; /*!< Mean output error of the last Activate. */
+};
+
+}  // end of namespace neat
+
+#endif  // NEATNEURALNETWORKBATCH_H
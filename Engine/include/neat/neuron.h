@@ -1,6 +1,7 @@
 #ifndef NEATNEURON_H
 #define NEATNEURON_H
 
+#include <cstdint>
 #include <vector>
 
 namespace neat {
@@ -19,10 +20,10 @@ enum class ActivationType { sigmoid, relu, elu, leakyRelu, binary, linear };
 class Neuron {
  public:
   explicit Neuron(NeuronType type, double bias);
-  explicit Neuron(int id, NeuronType type, double bias, bool active,
+  explicit Neuron(std::int64_t id, NeuronType type, double bias, bool active,
                   ActivationType activation);
 
-  int GetId() const;
+  std::int64_t GetId() const;
   NeuronType GetType() const;
   ActivationType GetActivation() const;
   double GetBias() const;
@@ -33,11 +34,8 @@ class Neuron {
   void SetInactive();
   void SetActivation(ActivationType activation);
 
-  static int next_id_; /*! Static variable used to assign unique IDs to new
-                          neurons. */
-
  private:
-  int id_;             /*! Unique identifier for the neuron. */
+  std::int64_t id_;    /*! Unique identifier for the neuron. */
   NeuronType type_;    /*! Type of the neuron (input, output, hidden). */
   ActivationType activation_; /*! Activation function of the neuron. */
   double bias_;        /*! Bias of the neuron. */
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "entity/creature/creature.h"
+#include "entity/creature/egg.h"
+#include "entity/creature/pheromone.h"
+#include "entity/food.h"
+
+struct SimulationData;
+
+/*!
+ * @class CommandBuffer
+ *
+ * @brief Structural changes recorded by one thread during a parallel pass.
+ *
+ * @details Every command carries the key given to CommandBuffers::Local, so
+ * the merged commands can be applied in an order independent of the thread
+ * schedule.
+ */
+class CommandBuffer {
+ public:
+  void Spawn(std::shared_ptr<Creature> creature);
+  void Spawn(std::shared_ptr<Egg> egg);
+  void Spawn(std::shared_ptr<Food> food);
+  void Spawn(std::shared_ptr<Pheromone> pheromone);
+  void Despawn(std::shared_ptr<Entity> entity);
+  void Transform(std::shared_ptr<Entity> entity,
+                 std::shared_ptr<Food> remains);
+
+  bool Empty() const;
+  void Clear();
+
+ private:
+  friend class CommandBuffers;
+
+  template <typename T>
+  struct Keyed {
+    std::int64_t key; /*!< Position of the command in the applied order. */
+    T value;          /*!< Payload of the command. */
+  };
+
+  std::int64_t key_ = 0; /*!< Key of the commands being recorded. */
+  std::vector<Keyed<std::shared_ptr<Creature>>> creatures_; /*!< Births. */
+  std::vector<Keyed<std::shared_ptr<Egg>>> eggs_;           /*!< Eggs laid. */
+  std::vector<Keyed<std::shared_ptr<Food>>> food_;          /*!< Food. */
+  std::vector<Keyed<std::shared_ptr<Pheromone>>> pheromones_; /*!< Emitted. */
+  std::vector<Keyed<std::shared_ptr<Entity>>> despawns_; /*!< Removals. */
+};
+
+/*!
+ * @class CommandBuffers
+ *
+ * @brief One CommandBuffer per thread, merged at a single sync point.
+ *
+ * @details Parallel loops record spawns, despawns and transforms into the
+ * buffer of their thread without locking. Apply then merges the buffers
+ * sorted by (phase, key), where the key is typically the loop index, and
+ * performs the changes on the SimulationData, so the outcome is the same for
+ * any number of threads. Despawned entities are marked dead and removed by
+ * the usual pass of the EntityGrid.
+ */
+class CommandBuffers {
+ public:
+  CommandBuffers();
+
+  void BeginPhase();
+  CommandBuffer& Local(int key);
+  void Apply(SimulationData& data);
+  bool Empty() const;
+
+ private:
+  std::vector<CommandBuffer> buffers_; /*!< Indexed by thread number. */
+  std::int64_t phase_ = 0; /*!< Orders the loops of one tick. */
+};
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <optional>
+
+#include "entity/creature/metabolism_batch.h"
+#include "neat/neural_network_batch.h"
 #include "simulation/entity_grid.h"
 #include "simulation/environment.h"
+#include "simulation/mate_matcher.h"
 #include "simulation/simulation_data.h"
+#include "simulation/species_manager.h"
 
 class CreatureManager {
  public:
@@ -17,8 +23,28 @@ class CreatureManager {
   void HatchEggs(SimulationData& data, Environment& environment);
   void ReproduceCreatures(SimulationData& data, Environment& environment);
 
+  const SpeciesManager& GetSpeciesManager() const;
+
+  const neat::NeuralNetworkBatch& GetBrainBatch() const;
+  long GetThinks() const;
+  long GetSkippedThinks() const;
+  double GetThinkSkipRate() const;
+
  private:
   void ReproduceTwoCreatures(SimulationData& data,
                              std::shared_ptr<Creature> creature1,
-                             std::shared_ptr<Creature> creature2);
+                             std::shared_ptr<Creature> creature2,
+                             GestatingEgg egg);
+
+  LocomotionBatch locomotion_batch_; /*!< Creatures moving this tick. */
+  neat::NeuralNetworkBatch brain_batch_; /*!< Brains thinking this tick. */
+  std::vector<char> thinking_; /*!< Whether each creature thinks this tick. */
+  MetabolismBatch metabolism_batch_; /*!< Creatures metabolising this tick. */
+  std::vector<std::int64_t> spawns_; /*!< First entity id of each creature. */
+  long thinks_ = 0; /*!< Thinks since the start of the simulation. */
+  long skipped_thinks_ = 0; /*!< Thinks which reused the last outputs. */
+  SpeciesManager species_manager_; /*!< Species labels of the creatures. */
+  MateMatcher mate_matcher_; /*!< Pairs the creatures waiting to mate. */
+  std::vector<std::optional<GestatingEgg>> conceptions_; /*!< Per pair. */
+  std::vector<std::shared_ptr<Creature>> hatchlings_; /*!< Per egg. */
 };
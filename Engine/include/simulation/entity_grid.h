@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/scratch_arena.h"
 #include "simulation/environment.h"
 #include "simulation/simulation_data.h"
 
@@ -12,7 +13,8 @@ class EntityGrid {
   void UpdateGrid(SimulationData &data, Environment &environment, double deltaTime);
   void ClearGrid();
 
-  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> GetGrid() const;
+  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &GetGrid();
+  const std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &GetGrid() const;
 
   const std::vector<std::shared_ptr<Entity>>& GetEntitiesAt(const int row, const int col) const;
   const std::vector<std::shared_ptr<Entity>>& GetEntitiesAt(const std::pair<int, int>& coords) const;
@@ -20,6 +22,8 @@ class EntityGrid {
   const std::pair<int, int> GetGridSize() const;
 
   std::vector<std::pair<int, int>> GetNeighbours(const std::pair<int, int>& center, const int& layer_number);
+  void GetNeighbours(const std::pair<int, int>& center, int layer_number,
+                     ScratchVector<std::pair<int, int>>& neighbours) const;
 
  private:
   std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> grid_;
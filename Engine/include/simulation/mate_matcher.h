@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "entity/creature/creature.h"
+
+/*!
+ * @struct MatePair
+ *
+ * @brief A father and a mother chosen to mate.
+ */
+struct MatePair {
+  std::shared_ptr<Creature> father; /*!< Male ready to procreate. */
+  std::shared_ptr<Creature> mother; /*!< Female ready to procreate. */
+};
+
+/*!
+ * @class MateMatcher
+ *
+ * @brief Pairs the creatures waiting to reproduce with nearby partners.
+ *
+ * @details The waiting creatures are bucketed into square cells at least
+ * SETTINGS.compatibility.compatibility_distance wide, so every partner in
+ * range lies in the 3x3 block of cells around a creature. A father only
+ * considers the mothers of that block, nearest first and those of his own
+ * species before the others, and the genome distance is computed for the
+ * candidates that pass the distance and trait checks only.
+ *
+ * Cells are processed in nine colour classes by (column % 3, row % 3). The
+ * blocks of two cells of the same class never overlap, so the cells of a
+ * class are matched in parallel without locks, and the pairs are returned in
+ * an order independent of the thread schedule.
+ */
+class MateMatcher {
+ public:
+  std::vector<MatePair> Match(
+      const std::vector<std::shared_ptr<Creature>>& creatures);
+
+ private:
+  void MatchCell(const std::vector<std::shared_ptr<Creature>>& creatures,
+                 int column, int row, std::vector<MatePair>& pairs);
+
+  int columns_ = 1; /*!< Cells along the map width. */
+  int rows_ = 1;    /*!< Cells along the map height. */
+  std::vector<std::vector<int>> cells_; /*!< Waiting creatures, by cell. */
+  std::vector<char> matched_; /*!< Whether each creature found a partner. */
+  std::vector<std::vector<MatePair>> cell_pairs_; /*!< Pairs, by cell. */
+};
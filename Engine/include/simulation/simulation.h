@@ -20,6 +20,7 @@ class Simulation {
           environment);  // New constructor accepting Environment reference
   ~Simulation();
   DataAccessor<SimulationData> GetSimulationData();
+  const CreatureManager& GetCreatureManager() const;
   void Start();
   void Update(double deltaTime);
   void FixedUpdate(double deltaTime);
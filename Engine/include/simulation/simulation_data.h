@@ -1,5 +1,4 @@
 #pragma once
-#include <queue>
 #include <unordered_map>
 #include <vector>
 #include <memory>
@@ -10,6 +9,7 @@
 #include "simulation/environment.h"
 #include "entity/food.h"
 #include "entity/creature/pheromone.h"
+#include "simulation/command_buffer.h"
 
 struct SimulationData {
  public:
@@ -42,8 +42,7 @@ struct SimulationData {
   std::vector<std::shared_ptr<Food>> food_entities_;
   std::vector<std::shared_ptr<Egg>> eggs_;
   std::vector<std::shared_ptr<Pheromone>> pheromones_;
-  std::queue<std::shared_ptr<Creature>> reproduce_;
-  std::queue<std::shared_ptr<Creature>> new_reproduce_;
+  CommandBuffers commands_; /*!< Structural changes of the current tick. */
 
   double world_time_ = 0;
 
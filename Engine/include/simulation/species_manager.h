@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "entity/creature/creature.h"
+#include "simulation/simulation_data.h"
+
+/*!
+ * @struct Species
+ *
+ * @brief A species known to the SpeciesManager.
+ *
+ * @details Newcomers are compared against the representative only, never
+ * against the other members.
+ */
+struct Species {
+  int id;                                      /*!< Label, never 0. */
+  std::shared_ptr<const neat::Genome> genome;  /*!< Representative genome. */
+  std::size_t genome_hash;                     /*!< Its Genome::GetHash. */
+  Mutable mutables;                            /*!< Representative mutables. */
+  int size;                                    /*!< Members at last count. */
+};
+
+/*!
+ * @class SpeciesManager
+ *
+ * @brief Incremental NEAT speciation of the creatures.
+ *
+ * @details A creature joins the first species whose representative is
+ * compatible with it, by the same measure as Creature::Compatible, or founds a
+ * new one. Assignment costs one comparison per species. Every
+ * SETTINGS.compatibility.species_refresh_interval seconds of world time the
+ * members are counted, extinct species are dropped and each representative is
+ * replaced by a random living member. The label 0 means unassigned.
+ */
+class SpeciesManager {
+ public:
+  SpeciesManager();
+
+  int Assign(Creature& creature);
+  void Refresh(SimulationData& data);
+  void Clear();
+
+  const std::vector<Species>& GetSpecies() const;
+  int GetSpeciesCount() const;
+
+ private:
+  bool Compatible(const Species& species, const Creature& creature) const;
+
+  std::vector<Species> species_; /*!< Species in order of foundation. */
+  int next_species_id_;          /*!< Label of the next species. */
+  double last_refresh_;          /*!< World time of the last refresh. */
+};
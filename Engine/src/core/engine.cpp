@@ -5,6 +5,7 @@
 
 #include "simulation/simulation.h"
 #include "core/random.h"
+#include "core/thread_pool.h"
 
 Engine::Engine(double width, double height)
     : environment_(width, height), simulation_(new Simulation(environment_)), engine_speed_(1.0) {
@@ -15,7 +16,8 @@ Engine::Engine(double width, double height)
         std::cout << "Seed of the simulation: " << SETTINGS.random.seed << "\n";
     }
     Random::SetSeed(SETTINGS.random.seed);
-
+    ThreadPool::Global().Resize(SETTINGS.engine.threads,
+                                SETTINGS.engine.pin_threads);
 }
 
 Engine::Engine(double width, double height, double food_density,
@@ -23,6 +25,8 @@ Engine::Engine(double width, double height, double food_density,
     : environment_(width, height), simulation_(new Simulation(environment_)), engine_speed_(1.0) {
   environment_.SetFoodDensity(food_density);
   environment_.SetCreatureDensity(creature_density);
+  ThreadPool::Global().Resize(SETTINGS.engine.threads,
+                              SETTINGS.engine.pin_threads);
 }
 
 Engine::~Engine() { delete simulation_; }
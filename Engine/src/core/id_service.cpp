@@ -0,0 +1,140 @@
+#include "core/id_service.h"
+
+#include "core/settings.h"
+
+std::atomic<std::int64_t> IdService::next_[IdService::kKindCount] = {0, 1, 1};
+std::atomic<long> IdService::epoch_[IdService::kKindCount] = {0, 0, 0};
+thread_local IdService::Block IdService::blocks_[IdService::kKindCount];
+
+/*!
+ * @brief Allocates a new id.
+ *
+ * @details Served from the block of the thread, which within a ScopedJob is
+ * the range of the job.
+ *
+ * @param kind The kind of object the id is for.
+ *
+ * @return An id never returned before for this kind.
+ */
+std::int64_t IdService::Next(Kind kind) {
+  Block& block = blocks_[kind];
+  long epoch = epoch_[kind].load(std::memory_order_acquire);
+  if (block.next != block.end && block.epoch == epoch) {
+    return block.next++;
+  }
+  if (SETTINGS.random.input_seed) {
+    return next_[kind].fetch_add(1, std::memory_order_relaxed);
+  }
+  block.next = next_[kind].fetch_add(kBlockSize, std::memory_order_relaxed);
+  block.end = block.next + kBlockSize;
+  block.epoch = epoch;
+  return block.next++;
+}
+
+/*!
+ * @brief Reserves a range of consecutive ids, to be handed out through
+ * ScopedJob.
+ *
+ * @param kind The kind of the ids.
+ * @param count The number of ids.
+ *
+ * @return The first id of the range.
+ */
+std::int64_t IdService::Reserve(Kind kind, std::int64_t count) {
+  return next_[kind].fetch_add(count, std::memory_order_relaxed);
+}
+
+/*!
+ * @brief Reserves consecutive ranges of ids for the jobs of a parallel loop.
+ * Call from the thread starting the loop.
+ *
+ * @param jobs Number of jobs, typically the iterations of the loop.
+ * @param per_job Ids of each kind a job may take, 0 for the kinds it does
+ * not create.
+ *
+ * @return The ranges, job i of a kind starting at first + i * per_job.
+ */
+IdService::Batch IdService::ReserveBatch(
+    int jobs, const std::int64_t (&per_job)[kKindCount]) {
+  Batch batch;
+  for (int kind = 0; kind < kKindCount; kind++) {
+    if (jobs <= 0 || per_job[kind] <= 0) continue;
+    batch.per_job[kind] = per_job[kind];
+    batch.first[kind] = Reserve(static_cast<Kind>(kind), jobs * per_job[kind]);
+  }
+  return batch;
+}
+
+/*!
+ * @param batch The ranges of the loop.
+ * @param job Index of the job, in [0, jobs).
+ */
+IdService::ScopedJob::ScopedJob(const Batch& batch, int job) {
+  for (int kind = 0; kind < kKindCount; kind++) {
+    saved_[kind] = blocks_[kind];
+    if (batch.per_job[kind] == 0) continue;
+    Block& block = blocks_[kind];
+    block.next = batch.first[kind] + job * batch.per_job[kind];
+    block.end = block.next + batch.per_job[kind];
+    block.epoch = epoch_[kind].load(std::memory_order_acquire);
+  }
+}
+
+/*!
+ * @param kind The kind of ids the job takes from its range, the other kinds
+ * are allocated as usual.
+ * @param first First id of the range, from Reserve.
+ * @param count Ids in the range.
+ */
+IdService::ScopedJob::ScopedJob(Kind kind, std::int64_t first,
+                                std::int64_t count) {
+  for (int other = 0; other < kKindCount; other++) {
+    saved_[other] = blocks_[other];
+  }
+  Block& block = blocks_[kind];
+  block.next = first;
+  block.end = first + count;
+  block.epoch = epoch_[kind].load(std::memory_order_acquire);
+}
+
+IdService::ScopedJob::~ScopedJob() {
+  for (int kind = 0; kind < kKindCount; kind++) blocks_[kind] = saved_[kind];
+}
+
+/*!
+ * @brief Makes sure an id assigned elsewhere, e.g. loaded from a file, is
+ * never handed out.
+ *
+ * @details Outstanding blocks are retired, so this is meant for loading, not
+ * for the hot path.
+ *
+ * @param kind The kind of the id.
+ * @param id The id in use.
+ */
+void IdService::Observe(Kind kind, std::int64_t id) {
+  std::int64_t next = next_[kind].load(std::memory_order_relaxed);
+  while (next <= id &&
+         !next_[kind].compare_exchange_weak(next, id + 1,
+                                            std::memory_order_relaxed)) {
+  }
+  // the id may lie in a block some thread still serves from
+  epoch_[kind].fetch_add(1, std::memory_order_release);
+}
+
+/*!
+ * @brief Restarts the ids of a kind. Must not race with Next.
+ *
+ * @param kind The kind of the ids.
+ * @param first_id The next id to hand out.
+ */
+void IdService::Reset(Kind kind, std::int64_t first_id) {
+  next_[kind].store(first_id, std::memory_order_relaxed);
+  epoch_[kind].fetch_add(1, std::memory_order_release);
+}
+
+/*!
+ * @brief Returns the first id not reserved yet.
+ */
+std::int64_t IdService::Peek(Kind kind) {
+  return next_[kind].load(std::memory_order_relaxed);
+}
@@ -2,3 +2,4 @@
 
 std::random_device Random::rd;
 thread_local std::mt19937_64 Random::engine;
+thread_local Random::Stream* Random::stream = nullptr;
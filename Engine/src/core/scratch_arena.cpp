@@ -0,0 +1,119 @@
+#include "core/scratch_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+
+namespace {
+
+constexpr std::size_t kFirstBlock = 64 * 1024;
+
+/*!
+ * @brief The arenas of every live thread, for ResetAll.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::vector<ScratchArena *> arenas;
+};
+
+Registry &GetRegistry() {
+  static Registry *registry = new Registry();  // outlives the thread_locals
+  return *registry;
+}
+
+}  // namespace
+
+/*!
+ * @brief The arena of the calling thread.
+ */
+ScratchArena &ScratchArena::Local() {
+  thread_local ScratchArena arena;
+  return arena;
+}
+
+/*!
+ * @brief Rewinds the arena of every thread. Call outside parallel loops, once
+ * nothing allocated from the arenas is in use.
+ */
+void ScratchArena::ResetAll() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (ScratchArena *arena : registry.arenas) arena->Reset();
+}
+
+ScratchArena::ScratchArena() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.arenas.push_back(this);
+}
+
+ScratchArena::~ScratchArena() {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.arenas.erase(
+      std::find(registry.arenas.begin(), registry.arenas.end(), this));
+}
+
+/*!
+ * @brief Takes memory from the current block, chaining a new block if it is
+ * full.
+ *
+ * @param bytes Size of the allocation.
+ * @param alignment A power of two.
+ */
+void *ScratchArena::Allocate(std::size_t bytes, std::size_t alignment) {
+  if (!blocks_.empty()) {
+    const Block &block = blocks_.back();
+    const std::size_t offset = AlignedOffset(block.memory.get(), alignment);
+    if (offset + bytes <= block.size) {
+      used_ = offset + bytes;
+      return block.memory.get() + offset;
+    }
+  }
+  // new[] aligns to max_align_t, larger alignments get slack
+  const std::size_t slack =
+      alignment > alignof(std::max_align_t) ? alignment : 0;
+  AddBlock(std::max(bytes + slack,
+                    blocks_.empty() ? kFirstBlock : 2 * blocks_.back().size));
+  std::byte *memory = blocks_.back().memory.get();
+  const std::size_t offset = AlignedOffset(memory, alignment);
+  used_ = offset + bytes;
+  return memory + offset;
+}
+
+/*!
+ * @brief First offset at or past used_ whose address in a block is aligned.
+ */
+std::size_t ScratchArena::AlignedOffset(const std::byte *memory,
+                                        std::size_t alignment) const {
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(memory);
+  return ((base + used_ + alignment - 1) & ~(alignment - 1)) - base;
+}
+
+/*!
+ * @brief Frees everything allocated, merging the blocks into one.
+ */
+void ScratchArena::Reset() {
+  if (blocks_.size() > 1) {
+    const std::size_t capacity = GetCapacity();
+    blocks_.clear();
+    AddBlock(capacity);
+  }
+  used_ = 0;
+}
+
+/*!
+ * @brief Total size of the blocks.
+ */
+std::size_t ScratchArena::GetCapacity() const {
+  std::size_t capacity = 0;
+  for (const Block &block : blocks_) capacity += block.size;
+  return capacity;
+}
+
+int ScratchArena::GetBlockCount() const { return blocks_.size(); }
+
+void ScratchArena::AddBlock(std::size_t size) {
+  blocks_.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+  used_ = 0;
+}
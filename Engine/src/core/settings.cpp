@@ -40,6 +40,8 @@ void Settings::LoadFromFile(const std::string& filename) {
   compatibility.mutables_compatibility = compatibility_json["mutables_compatibility"].get<double>();
   compatibility.compatibility_threshold = compatibility_json["compatibility_threshold"].get<double>();
   compatibility.compatibility_distance = compatibility_json["compatibility_distance"].get<double>();
+  compatibility.compatibility_cache_size = compatibility_json["compatibility_cache_size"].get<int>();
+  compatibility.species_refresh_interval = compatibility_json["species_refresh_interval"].get<double>();
 
   // Load Environment settings
   auto& environment_json = config_json["environment"];
@@ -66,6 +68,7 @@ void Settings::LoadFromFile(const std::string& filename) {
   environment.reproduction_cooldown = environment_json["reproduction_cooldown"].get<double>();
   environment.input_neurons = environment_json["input_neurons"].get<int>();
   environment.output_neurons = environment_json["output_neurons"].get<int>();
+  environment.vision_rays = environment_json["vision_rays"].get<int>();
   environment.max_nutritional_value = environment_json["max_nutritional_value"].get<double>();
   environment.default_lifespan = environment_json["default_lifespan"].get<double>();
   environment.photosynthesis_factor = environment_json["photosynthesis_factor"].get<double>();
@@ -84,6 +87,12 @@ void Settings::LoadFromFile(const std::string& filename) {
   engine.eps = engine_json["eps"].get<double>();
   engine.max_cells_to_find_food = engine_json["max_cells_to_find_food"].get<size_t>();
   engine.max_food_density_colored = engine_json["max_food_density_colored"].get<double>();
+  engine.vision_refresh_interval = engine_json["vision_refresh_interval"].get<int>();
+  engine.think_skip_tolerance = engine_json["think_skip_tolerance"].get<double>();
+  engine.brain_precision = engine_json["brain_precision"].get<std::string>();
+  engine.validate_brain_precision = engine_json["validate_brain_precision"].get<bool>();
+  engine.threads = engine_json["threads"].get<int>();
+  engine.pin_threads = engine_json["pin_threads"].get<bool>();
 
   // Load Physical Constraints settings
   auto& physical_constraints_json = config_json["physical_constraints"];
@@ -0,0 +1,186 @@
+#include "core/thread_pool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "core/random.h"
+#include "core/settings.h"
+
+namespace {
+
+thread_local int thread_index = 0; /*!< 0 outside the pool. */
+
+/*!
+ * @brief Number of threads for a requested count, 0 meaning every core.
+ */
+int ThreadCount(int threads) {
+  if (threads > 0) return threads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}  // namespace
+
+/*!
+ * @brief The pool of the engine, sized from SETTINGS.engine on first use.
+ */
+ThreadPool &ThreadPool::Global() {
+  static ThreadPool pool(SETTINGS.engine.threads, SETTINGS.engine.pin_threads);
+  return pool;
+}
+
+/*!
+ * @param threads Number of threads including the caller, 0 for every core.
+ * @param pin Whether worker i is bound to core i.
+ */
+ThreadPool::ThreadPool(int threads, bool pin) { Start(threads, pin); }
+
+ThreadPool::~ThreadPool() { Stop(); }
+
+/*!
+ * @brief Replaces the workers if the thread count or the pinning changes.
+ * Call outside parallel loops.
+ *
+ * @details The workers are kept otherwise, with their scratch arenas and
+ * random engines.
+ */
+void ThreadPool::Resize(int threads, bool pin) {
+  if (ThreadCount(threads) == GetThreadCount() && pin == pin_) return;
+  Stop();
+  Start(threads, pin);
+}
+
+/*!
+ * @brief Number of threads running loops, the caller included.
+ */
+int ThreadPool::GetThreadCount() const { return queues_.size(); }
+
+/*!
+ * @brief Index of the calling thread: 0 outside the pool, 1 to
+ * GetThreadCount() - 1 for the workers.
+ */
+int ThreadPool::ThreadIndex() { return thread_index; }
+
+void ThreadPool::Start(int threads, bool pin) {
+  const int count = ThreadCount(threads);
+  pin_ = pin;
+  stopping_ = false;
+  queues_.clear();
+  for (int i = 0; i < count; i++) queues_.emplace_back(new Queue());
+  for (int i = 1; i < count; i++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i, pin);
+  }
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &worker : workers_) worker.join();
+  workers_.clear();
+}
+
+int ThreadPool::DefaultGrain(int count) const {
+  return std::max(1, count / static_cast<int>(8 * queues_.size()));
+}
+
+/*!
+ * @brief Deals the chunks of a loop to the queues and helps until they are
+ * all done.
+ *
+ * @param job The loop.
+ * @param bounds The chunks are [bounds[c], bounds[c + 1]).
+ */
+void ThreadPool::Run(Job &job, const ScratchVector<int> &bounds) {
+  const int chunks = bounds.size() - 1;
+  const int self = thread_index;
+  job.pending.store(chunks);
+  for (int c = 0; c < chunks; c++) {
+    Queue &queue = *queues_[(self + c) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back({&job, bounds[c], bounds[c + 1]});
+  }
+  queued_.fetch_add(chunks);
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_all();
+
+  while (job.pending.load() > 0) {
+    if (!RunOne(self)) std::this_thread::yield();
+  }
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+/*!
+ * @brief Takes a task from a queue.
+ *
+ * @param back Whether to take the newest task, as the owner does, or the
+ * oldest, as thieves do.
+ */
+bool ThreadPool::Pop(int queue, bool back, Task &task) {
+  Queue &q = *queues_[queue];
+  std::lock_guard<std::mutex> lock(q.mutex);
+  if (q.tasks.empty()) return false;
+  if (back) {
+    task = q.tasks.back();
+    q.tasks.pop_back();
+  } else {
+    task = q.tasks.front();
+    q.tasks.pop_front();
+  }
+  return true;
+}
+
+/*!
+ * @brief Runs one task, from the queue of the thread or stolen from another.
+ *
+ * @return Whether a task was run.
+ */
+bool ThreadPool::RunOne(int self) {
+  const int count = queues_.size();
+  Task task;
+  bool found = Pop(self, true, task);
+  for (int k = 1; !found && k < count; k++) {
+    found = Pop((self + k) % count, false, task);
+  }
+  if (!found) return false;
+  queued_.fetch_sub(1);
+
+  Job &job = *task.job;
+  try {
+    job.run(job.body, task.begin, task.end);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(job.error_mutex);
+    if (!job.error) job.error = std::current_exception();
+  }
+  job.pending.fetch_sub(1);
+  return true;
+}
+
+/*!
+ * @brief Body of worker index: seeds its random engine, so that seeded runs
+ * don't leave every worker on the same default stream, then runs chunks until
+ * the pool stops.
+ */
+void ThreadPool::WorkerLoop(int index, bool pin) {
+  thread_index = index;
+  Random::InitializeThreadLocalEngine(index);
+#ifdef __linux__
+  if (pin) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(index % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+#endif
+  while (true) {
+    if (RunOne(index)) continue;
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+    if (stopping_) return;
+  }
+}
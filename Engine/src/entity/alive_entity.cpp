@@ -1,12 +1,18 @@
 #include "entity/alive_entity.h"
 
 #include "core/settings.h"
+#include "neat/compatibility_cache.h"
 
-AliveEntity::AliveEntity(neat::Genome genome, Mutable mutables)
+AliveEntity::AliveEntity(const neat::Genome& genome, const Mutable& mutables)
+    : AliveEntity(std::make_shared<const neat::Genome>(genome), mutables) {}
+
+AliveEntity::AliveEntity(std::shared_ptr<const neat::Genome> genome,
+                         const Mutable& mutables)
     : Entity(),
       mutable_(mutables),
-      brain_(neat::NeuralNetwork(genome)),
+      brain_(genome),
       genome_(genome),
+      genome_hash_(genome->GetHash()),
       age_(0) {
     size_ = mutables.GetBabySize();
     health_ = mutables.GetIntegrity() *
@@ -15,7 +21,7 @@ AliveEntity::AliveEntity(neat::Genome genome, Mutable mutables)
             pow(size_, SETTINGS.environment.volume_dimension);
     energy_ = max_energy_/2;
     int neural_inputs = SETTINGS.environment.input_neurons;
-    for (BrainModule module : genome.GetModules()){
+    for (const BrainModule& module : genome->GetModules()){
         neural_inputs += module.GetInputNeuronIds().size();
     }
     neuron_data_ = std::vector<double> (neural_inputs, 0);
@@ -179,7 +185,43 @@ void AliveEntity::UpdateAge(double delta_time) {
  *
  * @return The genome of the AliveEntity.
  */
-neat::Genome AliveEntity::GetGenome() const { return genome_; }
+const neat::Genome& AliveEntity::GetGenome() const { return *genome_; }
+
+/*!
+ * @brief Retrieves the shared handle of the AliveEntity's genome.
+ *
+ * @details Offspring and clones built from this handle share the genome
+ * instead of copying it.
+ *
+ * @return The shared genome of the AliveEntity.
+ */
+std::shared_ptr<const neat::Genome> AliveEntity::GetSharedGenome() const {
+  return genome_;
+}
+
+/*!
+ * @brief Retrieves the hash of the AliveEntity's genome, computed once at
+ * construction.
+ *
+ * @return The value of GetGenome().GetHash().
+ */
+std::size_t AliveEntity::GetGenomeHash() const { return genome_hash_; }
+
+/*!
+ * @brief Computes the compatibility distance between the genomes of two
+ * AliveEntities.
+ *
+ * @details Goes through the shared neat::CompatibilityCache, so repeated
+ * checks between the same genomes are a hash lookup.
+ *
+ * @param other The other AliveEntity.
+ *
+ * @return The brain distance between the two entities.
+ */
+double AliveEntity::BrainDistance(const AliveEntity& other) const {
+  return neat::CompatibilityCache::GetInstance().Distance(
+      genome_, genome_hash_, other.genome_, other.genome_hash_);
+}
 
 /*!
  * @brief Retrieves the AliveEntity's mutables
@@ -189,4 +231,4 @@ neat::Genome AliveEntity::GetGenome() const { return genome_; }
  *
  * @return The mutables of the AliveEntity.
  */
-Mutable AliveEntity::GetMutable() const { return mutable_; }
+const Mutable& AliveEntity::GetMutable() const { return mutable_; }
@@ -0,0 +1,85 @@
+#include "entity/creature/binding_plan.h"
+
+/*!
+ * @brief Number of neural inputs written by a kind of sensor.
+ */
+int SensorBinding::Width() const {
+  switch (kind) {
+    case kVision:
+      return 5;
+    case kGeolocation:
+      return 3;
+    case kRays:
+      return 3 * source;
+    default:
+      return 1;
+  }
+}
+
+/*!
+ * @brief Compiles the bindings of a genome.
+ *
+ * @param genome The genome, whose brain modules are bound.
+ * @param input_count Number of neural inputs of the creature.
+ * @param output_count Number of neural outputs of the creature.
+ */
+BindingPlan::BindingPlan(const neat::Genome& genome, int input_count,
+                         int output_count) {
+  AddSensor({SensorBinding::kBias, 0, 0}, input_count);
+  AddSensor({SensorBinding::kEnergy, 0, 1}, input_count);
+  AddSensor({SensorBinding::kHealth, 0, 2}, input_count);
+  AddSensor({SensorBinding::kVelocity, 0, 3}, input_count);
+  AddSensor({SensorBinding::kVelocityAngle, 0, 4}, input_count);
+  AddSensor({SensorBinding::kRotationalVelocity, 0, 5}, input_count);
+  AddSensor({SensorBinding::kEmptiness, 0, 6}, input_count);
+  AddSensor({SensorBinding::kVision, 0, 7}, input_count);
+
+  AddActuator(ActuatorBinding::kAcceleration, 0, 0, output_count);
+  AddActuator(ActuatorBinding::kAccelerationAngle, 1, 0, output_count);
+  AddActuator(ActuatorBinding::kRotationalAcceleration, 2, 0, output_count);
+  AddActuator(ActuatorBinding::kAttack, 3, 0, output_count);
+
+  int entity_in_sight = 1;
+  for (const BrainModule& module : genome.GetModules()) {
+    switch (module.GetModuleId()) {
+      case 1:  // geolocation
+        AddSensor({SensorBinding::kGeolocation, 0, module.GetFirstInputIndex()},
+                  input_count);
+        break;
+      case 2:  // pheromone
+        if (module.GetType() < 0 || module.GetType() >= kPheromoneTypes) break;
+        AddSensor({SensorBinding::kPheromone, module.GetType(),
+                   module.GetFirstInputIndex()},
+                  input_count);
+        AddActuator(ActuatorBinding::kPheromoneEmission,
+                    module.GetFirstOutputIndex(), module.GetType(),
+                    output_count);
+        break;
+      case 3:  // vision, one more entity in sight
+        AddSensor({SensorBinding::kVision, entity_in_sight++,
+                   module.GetFirstInputIndex()},
+                  input_count);
+        break;
+      case 4:  // ray-cast vision
+        AddSensor({SensorBinding::kRays,
+                   static_cast<int>(module.GetInputNeuronIds().size()) / 3,
+                   module.GetFirstInputIndex()},
+                  input_count);
+        break;
+    }
+  }
+}
+
+void BindingPlan::AddSensor(SensorBinding sensor, int input_count) {
+  if (sensor.destination < 0 ||
+      sensor.destination + sensor.Width() > input_count) {
+    return;
+  }
+  sensors_.push_back(sensor);
+}
+
+void BindingPlan::AddActuator(ActuatorBinding::Kind kind, int source,
+                              int target, int output_count) {
+  if (source < 0 || source >= output_count) return;
+  actuators_.push_back({kind, source, target});
+}
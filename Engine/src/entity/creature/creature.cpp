@@ -37,19 +37,30 @@
  * settings::environment::kDStomachCapacityFactor
  */
 
-Creature::Creature(neat::Genome genome, Mutable mutables)
+Creature::Creature(const neat::Genome& genome, const Mutable& mutables)
+    : Creature(std::make_shared<const neat::Genome>(genome), mutables) {}
+
+/*!
+ * @brief Construct a new Creature sharing an existing genome.
+ *
+ * @details The genome is immutable and reference counted, clones and hatched
+ * offspring share it with their parent or egg instead of copying it.
+ */
+Creature::Creature(std::shared_ptr<const neat::Genome> genome,
+                   const Mutable& mutables)
     : Entity(),
       MovableEntity(),
       AliveEntity(genome, mutables),
-      VisionSystem(genome, mutables),
-      DigestiveSystem(genome, mutables),
-      ReproductiveSystem(genome, mutables),
-      MaleReproductiveSystem(genome, mutables),
-      FemaleReproductiveSystem(genome, mutables),
-      PheromoneSystem(genome, mutables),
+      VisionSystem(*genome, mutables),
+      DigestiveSystem(*genome, mutables),
+      ReproductiveSystem(*genome, mutables),
+      MaleReproductiveSystem(*genome, mutables),
+      FemaleReproductiveSystem(*genome, mutables),
+      PheromoneSystem(*genome, mutables),
       mating_desire_(false),
-      species_id_(0) {
-  think_count_ = this->GetID();
+      species_id_(0),
+      bindings_(*genome, neuron_data_.size(), genome->GetOutputCount()) {
+  think_count_ = this->GetID() % 5;
   color_hue_ = mutables.GetColor();
 }
 
@@ -138,13 +149,14 @@ void Creature::UpdateMatingDesire() {
  */
 bool Creature::Compatible(const std::shared_ptr<Creature>other_creature) {
   if (this->GetID() == other_creature->GetID()) return false;
-  double brain_distance =
-      this->GetGenome().CompatibilityBetweenGenomes(other_creature->GetGenome());
   double mutable_distance = this->GetMutable().CompatibilityBetweenMutables(
       other_creature->GetMutable());
-  double physical_distance =
-      this->GetDistance(other_creature, SETTINGS.environment.map_width,
-                        SETTINGS.environment.map_height);
+  // the brain distance is never negative, skip it when the traits already
+  // exceed the threshold
+  if (mutable_distance >= SETTINGS.compatibility.compatibility_threshold) {
+    return false;
+  }
+  double brain_distance = BrainDistance(*other_creature);
   return brain_distance + mutable_distance <
              SETTINGS.compatibility.compatibility_threshold;
 }
@@ -168,6 +180,23 @@ void Creature::Update(double deltaTime, double const kMapWidth,
                       std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                       double GridCellSize, double frictional_coefficient) {
   if (state_ == Dead) return;
+  this->UpdateKinematics(deltaTime, kMapWidth, kMapHeight,
+                         frictional_coefficient);
+  this->Think(grid, GridCellSize, deltaTime, kMapWidth, kMapHeight);
+  this->UpdateMetabolism(deltaTime);
+}
+
+/*!
+ * @brief Moves and rotates the creature according to its current
+ * accelerations.
+ *
+ * @details First stage of Update, it runs before the creature senses its
+ * surroundings.
+ */
+void Creature::UpdateKinematics(double deltaTime, double const kMapWidth,
+                                double const kMapHeight,
+                                double frictional_coefficient) {
+  if (state_ == Dead) return;
   this->frictional_coefficient_ = frictional_coefficient;
   this->UpdateMaxEnergy();
   // this->SetAffectedByGrabbedEnttityAll(false);
@@ -175,7 +204,29 @@ void Creature::Update(double deltaTime, double const kMapWidth,
   this->UpdateVelocities(deltaTime);
   this->Move(deltaTime, kMapWidth, kMapHeight);
   this->Rotate(deltaTime);
-  this->Think(grid, GridCellSize, deltaTime, kMapWidth, kMapHeight);
+}
+
+/*!
+ * @brief Queues the motion of the creature in a batch, which then does what
+ * UpdateKinematics does for all the queued creatures at once.
+ */
+void Creature::QueueKinematics(LocomotionBatch &batch,
+                               double frictional_coefficient) {
+  if (state_ == Dead) return;
+  this->frictional_coefficient_ = frictional_coefficient;
+  this->UpdateMaxEnergy();
+  batch.Add(*this);
+}
+
+/*!
+ * @brief Digests, grows, ages and updates the reproductive systems and the
+ * energy of the creature.
+ *
+ * @details Last stage of Update, it runs after the creature has acted on the
+ * outputs of its brain.
+ */
+void Creature::UpdateMetabolism(double deltaTime) {
+  if (state_ == Dead) return;
   this->Digest(deltaTime);
   this->Grow(energy_/(1 + max_energy_) * deltaTime / 100);
   this->AddAcid((energy_ + 10) * deltaTime );
@@ -246,71 +297,181 @@ void Creature::OnCollision(std::shared_ptr<Entity>other_entity, double kMapWidth
  *
  * @details This method involves processing vision, updating neuron data based
  * on environmental stimuli, and determining movement and rotation based on the
- * outputs from the creature's neural network.
+ * outputs from the creature's neural network. It is equivalent to Sense,
+ * activating the brain and Act; the simulation runs those stages separately
+ * so that the brains of all thinking creatures are activated in one batch.
  *
  * @param grid The environmental grid.
  * @param GridCellSize Size of each cell in the grid.
  */
 void Creature::Think(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                      double GridCellSize, double deltaTime, double width, double height) {
+  if (!Sense(grid, GridCellSize, width, height)) return;
+  if (NeedsActivation()) brain_.Activate(neuron_data_, brain_output_);
+  Act();
+}
+
+/*!
+ * @brief Whether the next call to Sense scans the surroundings and thinks,
+ * which costs far more than the calls in between.
+ */
+bool Creature::ThinksNextSense() const {
+  return state_ != Dead && (think_count_ + 1) % 5 == 0;
+}
+
+/*!
+ * @brief Fills the neural inputs from the creature's surroundings.
+ *
+ * @details Creatures think every 5th call, staggered by id. The sensors of the
+ * binding plan, compiled at birth, write into their slots of the neural
+ * inputs.
+ *
+ * @param grid The environmental grid.
+ * @param GridCellSize Size of each cell in the grid.
+ *
+ * @return Whether the brain has to be activated this tick.
+ */
+bool Creature::Sense(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+                     double GridCellSize, double width, double height) {
+  if (state_ == Dead) return false;
   // Not pretty but we'll figure out a better way in the future
 
   think_count_++;
   if (think_count_ % 5 != 0){
-      return;
+      return false;
   }
   think_count_ = 0;
   // To allow creatures to use a module it should be included below
   ProcessPheromoneDetection(grid, GridCellSize);
 
-  std::vector<std::shared_ptr<Entity>> closeEntities = GetClosestEntitiesInSight(grid, GridCellSize, width, height);
+  auto closeEntities = GetClosestEntitiesInSight(grid, GridCellSize, width, height);
   if(closeEntities[0]) closest_entity_ = closeEntities[0];
 
-  if (neuron_data_.size() == 0) return;
-  neuron_data_.at(0) = 1;
-  neuron_data_.at(1) = energy_;
-  neuron_data_.at(2) = health_;
-  neuron_data_.at(3) = GetVelocity();
-  neuron_data_.at(4) = GetVelocityAngle();
-  neuron_data_.at(5) = GetRotationalVelocity();
-  neuron_data_.at(6) = GetEmptinessPercent();
-  ProcessVision(closeEntities[0], 7);
-
-  int entity_counter = 1;
-  for (BrainModule module : GetGenome().GetModules()) {
-    if (module.GetModuleId() == 1) {  // Geolocation Module
-      int i = module.GetFirstInputIndex();
-      neuron_data_.at(i) = x_coord_;
-      neuron_data_.at(i + 1) = y_coord_;
-      neuron_data_.at(i + 2) = orientation_;
-    }
-
-    if (module.GetModuleId() == 2){ //Pheromone Module
-        int i = module.GetFirstInputIndex();
-        int type = module.GetType();
-        neuron_data_.at(i) = pheromone_densities_.at(type);
-    }
-
-    if (module.GetModuleId() == 3){ //Vision Module
-        int i = module.GetFirstInputIndex();
-        ProcessVision(closeEntities[entity_counter], i);
-        entity_counter++;
+  if (neuron_data_.size() == 0) return false;
+  // the plan only holds bindings within the inputs
+  double* inputs = neuron_data_.data();
+  for (const SensorBinding& sensor : bindings_.GetSensors()) {
+    const int i = sensor.destination;
+    switch (sensor.kind) {
+      case SensorBinding::kBias:
+        inputs[i] = 1;
+        break;
+      case SensorBinding::kEnergy:
+        inputs[i] = energy_;
+        break;
+      case SensorBinding::kHealth:
+        inputs[i] = health_;
+        break;
+      case SensorBinding::kVelocity:
+        inputs[i] = GetVelocity();
+        break;
+      case SensorBinding::kVelocityAngle:
+        inputs[i] = GetVelocityAngle();
+        break;
+      case SensorBinding::kRotationalVelocity:
+        inputs[i] = GetRotationalVelocity();
+        break;
+      case SensorBinding::kEmptiness:
+        inputs[i] = GetEmptinessPercent();
+        break;
+      case SensorBinding::kVision:
+        ProcessVision(closeEntities[sensor.source], i);
+        break;
+      case SensorBinding::kGeolocation:
+        inputs[i] = x_coord_;
+        inputs[i + 1] = y_coord_;
+        inputs[i + 2] = orientation_;
+        break;
+      case SensorBinding::kPheromone:
+        inputs[i] = pheromone_densities_[sensor.source];
+        break;
+      case SensorBinding::kRays:
+        CastRays(grid, GridCellSize, width, height, sensor.source, inputs + i);
+        break;
     }
   }
 
-  std::vector<double> output = brain_.Activate(neuron_data_);
+  return true;
+}
 
-  SetAcceleration(std::tanh(output.at(0)) * mutable_.GetMaxForce());
-  SetAccelerationAngle(std::tanh(output.at(1)) * M_PI);
-  SetRotationalAcceleration(std::tanh(output.at(2))*mutable_.GetMaxForce());
-  attack_ = std::tanh(output.at(3)) > 0 ? 1 : 0;
+/*!
+ * @brief Queues the brain of the creature in a batch, reading the inputs
+ * filled by Sense and writing the outputs read by Act.
+ *
+ * @return Whether the brain was queued, false if Act can reuse the outputs of
+ * the last activation.
+ */
+bool Creature::QueueThink(neat::NeuralNetworkBatch &batch) {
+  if (!NeedsActivation()) return false;
+  batch.Add(brain_, neuron_data_, brain_output_);
+  return true;
+}
 
-  for (BrainModule& module : GetGenome().GetModules()){
-      if (module.GetModuleId() == 2){
-          int i = module.GetFirstOutputIndex();
-          int type = module.GetType();
-          pheromone_emissions_.at(type) = output.at(i);
+/*!
+ * @brief Whether the inputs filled by Sense have to go through the brain.
+ *
+ * @details With a positive SETTINGS.engine.think_skip_tolerance, a
+ * feed-forward brain is not activated again while every input stays within
+ * that tolerance, relative to its magnitude, of the inputs of its last
+ * activation; the outputs it gave then are still valid. Recurrent brains
+ * advance their state on every activation and are always activated. The
+ * inputs are compared to the last activated ones, not to the previous think,
+ * so slow drifts still trigger an activation. Inputs outside the binding
+ * plan never change and vision slots which stay empty count as unchanged.
+ */
+bool Creature::NeedsActivation() {
+  const double tolerance = SETTINGS.engine.think_skip_tolerance;
+  if (tolerance <= 0 || brain_.IsRecurrent()) return true;
+  if (!brain_output_.empty() && last_inputs_.size() == neuron_data_.size()) {
+    bool changed = false;
+    for (const SensorBinding& sensor : bindings_.GetSensors()) {
+      const int begin = sensor.destination;
+      // an empty vision slot only holds a random orientation
+      if (sensor.kind == SensorBinding::kVision &&
+          neuron_data_[begin + 2] == -1 && last_inputs_[begin + 2] == -1) {
+        continue;
+      }
+      for (int i = begin; i < begin + sensor.Width() && !changed; i++) {
+        changed = std::abs(neuron_data_[i] - last_inputs_[i]) >
+                  tolerance * (1 + std::abs(last_inputs_[i]));
       }
+      if (changed) break;
+    }
+    if (!changed) return false;
+  }
+  last_inputs_ = neuron_data_;
+  return true;
+}
+
+/*!
+ * @brief Applies the outputs of the last brain activation.
+ *
+ * @details Runs the actuators of the binding plan: the accelerations, the
+ * attack intention and the pheromone emissions of the creature.
+ */
+void Creature::Act() {
+  if (brain_output_.empty()) return;
+  const double* output = brain_output_.data();
+
+  for (const ActuatorBinding& actuator : bindings_.GetActuators()) {
+    const double value = output[actuator.source];
+    switch (actuator.kind) {
+      case ActuatorBinding::kAcceleration:
+        SetAcceleration(std::tanh(value) * mutable_.GetMaxForce());
+        break;
+      case ActuatorBinding::kAccelerationAngle:
+        SetAccelerationAngle(std::tanh(value) * M_PI);
+        break;
+      case ActuatorBinding::kRotationalAcceleration:
+        SetRotationalAcceleration(std::tanh(value) * mutable_.GetMaxForce());
+        break;
+      case ActuatorBinding::kAttack:
+        attack_ = std::tanh(value) > 0 ? 1 : 0;
+        break;
+      case ActuatorBinding::kPheromoneEmission:
+        pheromone_emissions_[actuator.target] = value;
+        break;
+    }
   }
 
   // grabbing_ = std::tanh(output.at(6)) > 0 ? 0 : 1;
@@ -339,6 +500,8 @@ void Creature::Grow(double energy) {
 
 bool Creature::GetMatingDesire() const { return mating_desire_; }
 
+const BindingPlan& Creature::GetBindingPlan() const { return bindings_; }
+
 /*!
  * @brief Handles the biting of the creature.
  *
@@ -395,24 +558,24 @@ void Creature::Grab(std::shared_ptr<Entity> entity){
  */
 void Creature::ProcessVision(std::shared_ptr<Entity> entity, int start) {
   if (entity){
-    neuron_data_.at(start) = this->GetDistance(entity) - entity->GetSize();
-    neuron_data_.at(start + 1)= this->GetRelativeOrientation(entity);
-    neuron_data_.at(start + 2) = entity->GetSize();
-    neuron_data_.at(start + 3) = entity->GetColor();
+    neuron_data_[start] = this->GetDistance(entity) - entity->GetSize();
+    neuron_data_[start + 1]= this->GetRelativeOrientation(entity);
+    neuron_data_[start + 2] = entity->GetSize();
+    neuron_data_[start + 3] = entity->GetColor();
 
     std::shared_ptr<Creature> otherCreature = std::dynamic_pointer_cast<Creature>(entity);
-    if (otherCreature && Compatible(otherCreature)) { neuron_data_.at(start + 4) = 1; entity_compatibility_ = 1;}
-    else{ neuron_data_.at(start + 4) = 0; entity_compatibility_ = 0;}
+    if (otherCreature && Compatible(otherCreature)) { neuron_data_[start + 4] = 1; entity_compatibility_ = 1;}
+    else{ neuron_data_[start + 4] = 0; entity_compatibility_ = 0;}
 
     std::shared_ptr<Egg> egg = std::dynamic_pointer_cast<Egg>(entity);
-    if (egg && egg->CompatibleWithCreature(GetGenome(), GetMutable())) { neuron_data_.at(start + 4) = 1; entity_compatibility_ = 1;}
-    else{ neuron_data_.at(start + 4) = 0; entity_compatibility_ = 0;}
+    if (egg && egg->CompatibleWithCreature(*this)) { neuron_data_[start + 4] = 1; entity_compatibility_ = 1;}
+    else{ neuron_data_[start + 4] = 0; entity_compatibility_ = 0;}
   }
   else {
-    neuron_data_.at(start) =  vision_radius_;
-    neuron_data_.at(start + 1) = remainder(Random::Double(orientation_- vision_angle_/2, orientation_+ vision_angle_/2), 2*M_PI);
-    neuron_data_.at(start + 2) = -1;
-    neuron_data_.at(start + 3) = 0;
-    neuron_data_.at(start + 4) = 0;
+    neuron_data_[start] =  vision_radius_;
+    neuron_data_[start + 1] = remainder(Random::Double(orientation_- vision_angle_/2, orientation_+ vision_angle_/2), 2*M_PI);
+    neuron_data_[start + 2] = -1;
+    neuron_data_[start + 3] = 0;
+    neuron_data_[start + 4] = 0;
   }
 }
@@ -1,7 +1,7 @@
 #include "entity/creature/digestive_system.h"
 #include "core/settings.h"
 
-DigestiveSystem::DigestiveSystem(neat::Genome genome, Mutable mutables)
+DigestiveSystem::DigestiveSystem(const neat::Genome& genome, const Mutable& mutables)
     : AliveEntity(genome, mutables),
       eating_cooldown_ (mutables.GetEatingSpeed()),
       stomach_acid_ (0.0),
@@ -1,14 +1,24 @@
 #include "entity/creature/egg.h"
+
+#include <cmath>
+
 #include "core/settings.h"
+#include "neat/compatibility_cache.h"
 
 Egg::Egg(const GestatingEgg& gestating_egg,
          const std::pair<double, double>& coordinates)
     : Entity(coordinates.first, coordinates.second, 0),
-      AliveEntity(gestating_egg.genome, gestating_egg.mutables),
+      genome_(gestating_egg.genome),
+      genome_hash_(gestating_egg.genome->GetHash()),
+      mutable_(gestating_egg.mutables),
+      age_(gestating_egg.age),
+      health_(gestating_egg.mutables.GetIntegrity() *
+              pow(gestating_egg.mutables.GetBabySize(),
+                  SETTINGS.environment.volume_dimension) /
+              2),
       generation_(gestating_egg.generation),
       incubation_time_(gestating_egg.incubation_time),
       nutritional_value_(SETTINGS.environment.egg_nutritional_value){
-  age_ = gestating_egg.age;
   color_hue_ = mutable_.GetColor();
   Update(0);
 }
@@ -16,19 +26,23 @@ Egg::Egg(const GestatingEgg& gestating_egg,
 double Egg::GetIncubationTime() const { return incubation_time_; }
 
 void Egg::Update(double delta_time) {
-  if (AliveEntity::GetState() == Dead) {
+  if (GetState() == Dead) {
     return;
   }
 
   age_ += delta_time;
 
-  SetSize((0.5 + age_ / incubation_time_) * AliveEntity::GetMutable().GetBabySize());
+  SetSize((0.5 + age_ / incubation_time_) * GetMutable().GetBabySize());
 }
 
-void Egg::Break() { AliveEntity::SetState(Dead); }
+void Egg::Break() { SetState(Dead); }
 
+/*!
+ * @brief Turns the egg into a creature, whose brain is compiled from the
+ * shared genome.
+ */
 std::shared_ptr<Creature> Egg::Hatch() {
-  if (AliveEntity::GetState() == Dead) {
+  if (GetState() == Dead) {
     throw std::runtime_error("Cannot hatch a dead egg");
   }
   if (age_ < incubation_time_) {
@@ -53,14 +67,16 @@ std::shared_ptr<Creature> Egg::Hatch() {
  * characteristics compatibility. The creatures are considered compatible if the
  * sum is less than a predefined compatibility threshold.
  *
- * @param other_creature A reference to another `Creature` object for
- * compatibility comparison.
+ * @param creature The creature to compare with.
  * @return bool Returns `true` if the sum of brain and mutable distances is less
  * than the compatibility threshold, indicating compatibility; otherwise returns
  * `false`.
  */
-bool Egg::CompatibleWithCreature(neat::Genome genome, Mutable mutables) {
-  double brain_distance = this->GetGenome().CompatibilityBetweenGenomes(genome);
-  double mutable_distance = this->GetMutable().CompatibilityBetweenMutables(mutables);
+bool Egg::CompatibleWithCreature(const AliveEntity& creature) const {
+  double brain_distance = neat::CompatibilityCache::GetInstance().Distance(
+      genome_, genome_hash_, creature.GetSharedGenome(),
+      creature.GetGenomeHash());
+  double mutable_distance =
+      this->GetMutable().CompatibilityBetweenMutables(creature.GetMutable());
   return brain_distance + mutable_distance < SETTINGS.compatibility.compatibility_threshold;
 }
@@ -0,0 +1,201 @@
+#include "entity/creature/metabolism_batch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/random.h"
+#include "core/settings.h"
+#include "core/thread_pool.h"
+#include "entity/creature/creature.h"
+
+/*!
+ * @brief Removes every queued creature, keeping the buffers for the next step.
+ */
+void MetabolismBatch::Clear() { creatures_.clear(); }
+
+/*!
+ * @brief Queues a creature for the next call to Step.
+ */
+void MetabolismBatch::Add(Creature &creature) {
+  creatures_.push_back(&creature);
+}
+
+int MetabolismBatch::GetSize() const { return creatures_.size(); }
+
+/*!
+ * @brief Whether each queued creature is dead after the last Step.
+ */
+const std::vector<char> &MetabolismBatch::GetDeaths() const { return deaths_; }
+
+/*!
+ * @brief Updates the metabolism of every queued creature.
+ *
+ * @details Same model, in the same order, as Creature::UpdateMetabolism. The
+ * conditional updates of the scalar path are written as selects, so the pass
+ * has no branches; the lanes of dead creatures are computed but not written
+ * back. The random draw of each creature is made serially beforehand.
+ *
+ * @param delta_time The time interval of the step.
+ */
+void MetabolismBatch::Step(double delta_time) {
+  const int n = creatures_.size();
+  for (auto *lane :
+       {&energy_, &health_, &size_, &age_, &acid_, &fullness_,
+        &stomach_energy_, &capacity_, &bite_, &cooldown_, &egg_age_,
+        &max_energy_, &ready_at_, &maturity_, &effort_, &hardship_, &random_,
+        &integrity_, &growth_factor_, &max_size_, &stomach_factor_, &strength_,
+        &energy_loss_, &energy_density_}) {
+    lane->resize(n);
+  }
+  alive_.resize(n);
+  pregnant_.resize(n);
+  desire_.resize(n);
+  deaths_.resize(n);
+
+  // the mating desire draws come from the calling thread, in creature order,
+  // so they don't depend on which thread gathers which creature
+  for (int i = 0; i < n; i++) random_[i] = Random::Double(0, 1);
+
+  ThreadPool::Global().ParallelFor(0, n, [&](int i) {
+    const Creature &creature = *creatures_[i];
+    const Mutable &mutables = creature.mutable_;
+    energy_[i] = creature.energy_;
+    health_[i] = creature.health_;
+    size_[i] = creature.size_;
+    age_[i] = creature.age_;
+    acid_[i] = creature.stomach_acid_;
+    fullness_[i] = creature.stomach_fullness_;
+    stomach_energy_[i] = creature.potential_energy_in_stomach_;
+    capacity_[i] = creature.stomach_capacity_;
+    bite_[i] = creature.bite_strength_;
+    cooldown_[i] = creature.eating_cooldown_;
+    egg_age_[i] = creature.egg_ ? creature.egg_->age : 0;
+    max_energy_[i] = creature.max_energy_;
+    ready_at_[i] = creature.ready_to_reproduce_at_;
+    maturity_[i] = creature.maturity_age_;
+    effort_[i] = std::fabs(creature.acceleration_) +
+                 std::fabs(creature.rotational_acceleration_);
+    hardship_[i] = creature.pregnancy_hardship_;
+    integrity_[i] = mutables.GetIntegrity();
+    growth_factor_[i] = mutables.GetGrowthFactor();
+    max_size_[i] = mutables.GetMaxSize();
+    stomach_factor_[i] = mutables.GetStomachCapacityFactor();
+    strength_[i] = mutables.GetGeneticStrength();
+    energy_loss_[i] = mutables.GetEnergyLoss();
+    energy_density_[i] = mutables.GetEnergyDensity();
+    alive_[i] = creature.state_ != Entity::Dead;
+    pregnant_[i] = creature.egg_.has_value();
+  });
+
+  const double dt = delta_time;
+  const double eps = SETTINGS.engine.eps;
+  const double digestion = dt * SETTINGS.physical_constraints.d_digestion_rate;
+  const double acid_to_energy = SETTINGS.physical_constraints.d_acid_to_energy;
+  const double max_age = SETTINGS.physical_constraints.max_reproducing_age;
+  const double desire_factor =
+      SETTINGS.physical_constraints.mating_desire_factor;
+  const double movement_cost = dt * SETTINGS.environment.movement_energy;
+  const double heat_cost = dt * SETTINGS.environment.heat_energy;
+  const double volume_dimension = SETTINGS.environment.volume_dimension;
+
+  ThreadPool::Global().ParallelForRange(0, n, [&](int begin, int end) {
+#pragma omp simd
+    for (int i = begin; i < end; i++) {
+      const double max_energy = max_energy_[i];
+      double energy = energy_[i], health = health_[i], size = size_[i];
+      double acid = acid_[i], fullness = fullness_[i];
+      double stomach_energy = stomach_energy_[i], capacity = capacity_[i];
+
+      // Digest
+      double quantity = std::min(std::min(digestion, acid), fullness);
+      const bool digest = !(quantity < eps || fullness < eps);
+      const double nutrition = stomach_energy / (digest ? fullness : 1.0);
+      quantity = digest ? quantity : 0.0;
+      energy = digest ? std::min(energy + quantity * nutrition, max_energy)
+                      : energy;
+      const double digested_acid = acid - quantity;
+      acid = digest ? (digested_acid > capacity ? capacity
+                       : digested_acid < 0  ? 0.0
+                                            : digested_acid)
+                    : acid;
+      stomach_energy -= quantity * nutrition;
+      const double digested_fullness = fullness - quantity;
+      fullness = digest ? (digested_fullness > capacity ? capacity
+                           : digested_fullness < 0  ? 0.0
+                                                    : digested_fullness)
+                        : fullness;
+
+      // Grow
+      const double growth = energy / (1 + max_energy) * dt / 100;
+      size = std::min(size + growth * growth_factor_[i], max_size_[i]);
+      energy = std::min(energy - growth, max_energy);
+      capacity = stomach_factor_[i] * size * size;
+
+      // AddAcid
+      const double initial_acid = acid;
+      acid = std::min(capacity, acid + (energy + 10) * dt);
+      energy = std::min(energy - (acid - initial_acid) / acid_to_energy,
+                        max_energy);
+
+      // UpdateMatingDesire, before aging
+      const double age = age_[i];
+      const double probability =
+          1 - (age - maturity_[i]) / (max_age - maturity_[i]) * desire_factor;
+      desire_[i] = age >= ready_at_[i] && age < max_age &&
+                   !(energy < std::max(energy_density_[i] * size * size * 0.25,
+                                       max_energy * 0.6)) &&
+                   random_[i] < probability;
+
+      // reproductive clocks and UpdateAge
+      egg_age_[i] += pregnant_[i] ? dt : 0.0;
+      age_[i] = age + dt;
+
+      // UpdateEnergy and BalanceHealthEnergy
+      energy = std::min(energy -
+                            effort_[i] * size * movement_cost * hardship_[i] -
+                            energy_loss_[i] * size * heat_cost,
+                        max_energy);
+      const double max_health = integrity_[i] * size * size;
+      const bool starving = energy < 0;
+      const bool healing =
+          !starving &&
+          health < integrity_[i] * std::pow(size, volume_dimension) &&
+          energy >= 0.7 * max_energy;
+      health = starving  ? std::min(health + energy - 0.1, max_health)
+               : healing ? std::min(health + 0.1, max_health)
+                         : health;
+      energy = starving  ? std::min(0.1, max_energy)
+               : healing ? std::min(energy - 0.1, max_energy)
+                         : energy;
+
+      cooldown_[i] = cooldown_[i] <= 0 ? 0.0 : cooldown_[i] - dt;
+      energy_[i] = energy;
+      health_[i] = health;
+      size_[i] = size;
+      acid_[i] = acid;
+      fullness_[i] = fullness;
+      stomach_energy_[i] = stomach_energy;
+      capacity_[i] = capacity;
+      bite_[i] = strength_[i] * size;
+      deaths_[i] = !alive_[i] || health <= 0;
+    }
+  });
+
+  ThreadPool::Global().ParallelFor(0, n, [&](int i) {
+    if (!alive_[i]) return;
+    Creature &creature = *creatures_[i];
+    creature.energy_ = energy_[i];
+    creature.health_ = health_[i];
+    creature.size_ = size_[i];
+    creature.age_ = age_[i];
+    creature.stomach_acid_ = acid_[i];
+    creature.stomach_fullness_ = fullness_[i];
+    creature.potential_energy_in_stomach_ = stomach_energy_[i];
+    creature.stomach_capacity_ = capacity_[i];
+    creature.bite_strength_ = bite_[i];
+    creature.eating_cooldown_ = cooldown_[i];
+    if (creature.egg_) creature.egg_->age = egg_age_[i];
+    creature.mating_desire_ = desire_[i];
+    if (deaths_[i]) creature.Dies();
+  });
+}
@@ -14,26 +14,26 @@
  * @details Initializes the Mutable object with predefined values from the
  *          SETTINGS.physical_constraints namespace.
  */
-Mutable::Mutable()
-  : energy_density_(SETTINGS.physical_constraints.d_energy_density),
-    energy_loss_(SETTINGS.physical_constraints.d_energy_loss),
-    integrity_(SETTINGS.physical_constraints.d_integrity),
-    strafing_difficulty_(SETTINGS.physical_constraints.d_strafing_difficulty),
-    max_size_(SETTINGS.physical_constraints.d_max_size),
-    baby_size_(SETTINGS.physical_constraints.d_baby_size),
-    max_force_(SETTINGS.physical_constraints.d_max_force),
-    growth_factor_(SETTINGS.physical_constraints.d_growth_factor),
-    vision_factor_(SETTINGS.physical_constraints.d_vision_factor),
-    color_(Random::Double(0, 1)),
-    stomach_capacity_factor_(SETTINGS.physical_constraints.d_stomach_capacity),
-    diet_(SETTINGS.physical_constraints.d_diet),
-    genetic_strength_(SETTINGS.physical_constraints.d_genetic_strength),
-    eating_speed_(SETTINGS.physical_constraints.d_eating_cooldown),
-    pheromone_emission_(SETTINGS.physical_constraints.d_pheromone_emission),
-    gestation_ratio_to_incubation_(SETTINGS.physical_constraints.
-                                   d_gestation_ratio_to_incubation)
-{
-
+Mutable::Mutable() : color_(Random::Double(0, 1)) {
+  traits_[kEnergyDensity] = SETTINGS.physical_constraints.d_energy_density;
+  traits_[kEnergyLoss] = SETTINGS.physical_constraints.d_energy_loss;
+  traits_[kIntegrity] = SETTINGS.physical_constraints.d_integrity;
+  traits_[kStrafingDifficulty] =
+      SETTINGS.physical_constraints.d_strafing_difficulty;
+  traits_[kMaxSize] = SETTINGS.physical_constraints.d_max_size;
+  traits_[kBabySize] = SETTINGS.physical_constraints.d_baby_size;
+  traits_[kMaxForce] = SETTINGS.physical_constraints.d_max_force;
+  traits_[kGrowthFactor] = SETTINGS.physical_constraints.d_growth_factor;
+  traits_[kVisionFactor] = SETTINGS.physical_constraints.d_vision_factor;
+  traits_[kGestationRatioToIncubation] =
+      SETTINGS.physical_constraints.d_gestation_ratio_to_incubation;
+  traits_[kStomachCapacityFactor] =
+      SETTINGS.physical_constraints.d_stomach_capacity;
+  traits_[kDiet] = SETTINGS.physical_constraints.d_diet;
+  traits_[kGeneticStrength] = SETTINGS.physical_constraints.d_genetic_strength;
+  traits_[kEatingSpeed] = SETTINGS.physical_constraints.d_eating_cooldown;
+  traits_[kPheromoneEmission] =
+      SETTINGS.physical_constraints.d_pheromone_emission;
 }
 
 /*!
@@ -44,16 +44,16 @@ Mutable::Mutable()
  */
 double Mutable::Complexity() const {
   //values to tweak in order to achieve ideal conditions
-  double complexity = (energy_density_*10
-                       + 5/energy_loss_
-                       + integrity_ * 20
-                       + 5/(1+strafing_difficulty_)
-                       + max_force_ * 2
-                       + 5/growth_factor_
-                       + stomach_capacity_factor_
-                       + eating_speed_
-                       + genetic_strength_
-                       + pheromone_emission_) * baby_size_/12;
+  double complexity = (traits_[kEnergyDensity]*10
+                       + 5/traits_[kEnergyLoss]
+                       + traits_[kIntegrity] * 20
+                       + 5/(1+traits_[kStrafingDifficulty])
+                       + traits_[kMaxForce] * 2
+                       + 5/traits_[kGrowthFactor]
+                       + traits_[kStomachCapacityFactor]
+                       + traits_[kEatingSpeed]
+                       + traits_[kGeneticStrength]
+                       + traits_[kPheromoneEmission]) * traits_[kBabySize]/12;
   return complexity;
 }
 
@@ -68,8 +68,8 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_energy_density / 20);
-    energy_density_ += delta;
-    energy_density_ = mathlib::bound(energy_density_, 0.01,
+    traits_[kEnergyDensity] += delta;
+    traits_[kEnergyDensity] = mathlib::bound(traits_[kEnergyDensity], 0.01,
                                      SETTINGS.physical_constraints.max_energy_density);
   }
 
@@ -77,9 +77,9 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_energy_loss / 20);    
-    energy_loss_ += delta;
-    if (energy_loss_ < SETTINGS.physical_constraints.min_energy_loss) {
-      energy_loss_ = SETTINGS.physical_constraints.min_energy_loss;
+    traits_[kEnergyLoss] += delta;
+    if (traits_[kEnergyLoss] < SETTINGS.physical_constraints.min_energy_loss) {
+      traits_[kEnergyLoss] = SETTINGS.physical_constraints.min_energy_loss;
     }
   }
 
@@ -87,9 +87,9 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_energy_density / 20);    
-    integrity_ += delta;
-    if (integrity_ < 0.01) {
-      integrity_ = 0.01;
+    traits_[kIntegrity] += delta;
+    if (traits_[kIntegrity] < 0.01) {
+      traits_[kIntegrity] = 0.01;
     }
   }
 
@@ -97,9 +97,9 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_strafing_difficulty / 20);   
-    strafing_difficulty_ += delta;
-    if (strafing_difficulty_ < 0.01) {
-      strafing_difficulty_ = 0.01;
+    traits_[kStrafingDifficulty] += delta;
+    if (traits_[kStrafingDifficulty] < 0.01) {
+      traits_[kStrafingDifficulty] = 0.01;
     }
   }
 
@@ -107,9 +107,9 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_max_size / 20);    
-    max_size_ += delta;
-    if (max_size_ < SETTINGS.environment.min_creature_size) {
-      max_size_ = SETTINGS.environment.min_creature_size;
+    traits_[kMaxSize] += delta;
+    if (traits_[kMaxSize] < SETTINGS.environment.min_creature_size) {
+      traits_[kMaxSize] = SETTINGS.environment.min_creature_size;
     }
   }
 
@@ -117,18 +117,18 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_baby_size / 20);    
-    baby_size_ += delta;
-    baby_size_ = mathlib::bound(baby_size_, SETTINGS.environment.min_creature_size,
-                                max_size_);
+    traits_[kBabySize] += delta;
+    traits_[kBabySize] = mathlib::bound(traits_[kBabySize], SETTINGS.environment.min_creature_size,
+                                traits_[kMaxSize]);
   }
 
   // Max Force
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_max_force / 20);    
-    max_force_ += delta;
-    if (max_force_ < 0.01) {
-      max_force_ = 0.01;
+    traits_[kMaxForce] += delta;
+    if (traits_[kMaxForce] < 0.01) {
+      traits_[kMaxForce] = 0.01;
     }
   }
 
@@ -136,9 +136,9 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_max_force / 20);    
-    growth_factor_ += delta;
-    if (growth_factor_ < 0.01) {
-      growth_factor_ = 0.01;
+    traits_[kGrowthFactor] += delta;
+    if (traits_[kGrowthFactor] < 0.01) {
+      traits_[kGrowthFactor] = 0.01;
     }
   }
 
@@ -146,10 +146,10 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_vision_factor / 20);    
-    vision_factor_ += delta;
-    if (SETTINGS.physical_constraints.vision_ar_ratio / vision_factor_ >
+    traits_[kVisionFactor] += delta;
+    if (SETTINGS.physical_constraints.vision_ar_ratio / traits_[kVisionFactor] >
         2 * M_PI) {
-      vision_factor_ =
+      traits_[kVisionFactor] =
           SETTINGS.physical_constraints.vision_ar_ratio / (2 * M_PI);
     }
   }
@@ -159,9 +159,9 @@ void Mutable::Mutate() {
     double delta = Random::Normal(
         0.0,
         SETTINGS.physical_constraints.d_gestation_ratio_to_incubation / 20);    
-    gestation_ratio_to_incubation_ += delta;
-    gestation_ratio_to_incubation_ =
-        mathlib::bound(gestation_ratio_to_incubation_, 0.01, 0.99);
+    traits_[kGestationRatioToIncubation] += delta;
+    traits_[kGestationRatioToIncubation] =
+        mathlib::bound(traits_[kGestationRatioToIncubation], 0.01, 0.99);
   }
 
   // Color
@@ -181,98 +181,98 @@ void Mutable::Mutate() {
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_stomach_capacity / 20);
-    stomach_capacity_factor_ += delta;
-    stomach_capacity_factor_ = mathlib::bound(stomach_capacity_factor_, 0.01, 1);
+    traits_[kStomachCapacityFactor] += delta;
+    traits_[kStomachCapacityFactor] = mathlib::bound(traits_[kStomachCapacityFactor], 0.01, 1);
   }
 
   // Diet
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(0.0,
                                    SETTINGS.physical_constraints.d_diet / 10);
-    diet_ += delta;
-    diet_ = mathlib::bound(diet_, 0.1, 0.9);
+    traits_[kDiet] += delta;
+    traits_[kDiet] = mathlib::bound(traits_[kDiet], 0.1, 0.9);
   }
 
   // Genetic Strength
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate) {
     double delta = Random::Normal(
         0.0, SETTINGS.physical_constraints.d_genetic_strength / 10);
-    genetic_strength_ += delta;
-    genetic_strength_ = mathlib::bound(genetic_strength_, 0.2, 1.2);
+    traits_[kGeneticStrength] += delta;
+    traits_[kGeneticStrength] = mathlib::bound(traits_[kGeneticStrength], 0.2, 1.2);
   }
 
   //Eating Speed
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate){
     double delta = Random::Normal(0.0,
                                    SETTINGS.physical_constraints.d_eating_speed/10);
-    eating_speed_ += delta;
-    if (eating_speed_  < 0.2) {
-        eating_speed_ = 0.2;
+    traits_[kEatingSpeed] += delta;
+    if (traits_[kEatingSpeed]  < 0.2) {
+        traits_[kEatingSpeed] = 0.2;
     }
-    if (eating_speed_ > 1.2) {
-        eating_speed_ = 1.2;
+    if (traits_[kEatingSpeed] > 1.2) {
+        traits_[kEatingSpeed] = 1.2;
     }
   }
 
   if (Random::Double(0.0, 1.0) < SETTINGS.physical_constraints.mutation_rate){
     double delta = Random::Normal(0.0,
                                    SETTINGS.physical_constraints.d_pheromone_emission/10);
-    pheromone_emission_ += delta;
-    if (pheromone_emission_  < 0) {
-        pheromone_emission_ = 0;
+    traits_[kPheromoneEmission] += delta;
+    if (traits_[kPheromoneEmission]  < 0) {
+        traits_[kPheromoneEmission] = 0;
     }
-    if (pheromone_emission_ > 1) {
-        pheromone_emission_ = 1;
+    if (traits_[kPheromoneEmission] > 1) {
+        traits_[kPheromoneEmission] = 1;
     }
   }
 }
 
 // Getters
-double Mutable::GetEnergyDensity() const { return energy_density_; }
-double Mutable::GetEnergyLoss() const { return energy_loss_; }
-double Mutable::GetIntegrity() const { return integrity_; }
-double Mutable::GetStrafingDifficulty() const { return strafing_difficulty_; }
-double Mutable::GetMaxSize() const { return max_size_; }
-double Mutable::GetBabySize() const { return baby_size_; }
-double Mutable::GetMaxForce() const { return max_force_; }
-double Mutable::GetGrowthFactor() const { return growth_factor_; }
-double Mutable::GetVisionFactor() const { return vision_factor_; }
+double Mutable::GetEnergyDensity() const { return traits_[kEnergyDensity]; }
+double Mutable::GetEnergyLoss() const { return traits_[kEnergyLoss]; }
+double Mutable::GetIntegrity() const { return traits_[kIntegrity]; }
+double Mutable::GetStrafingDifficulty() const { return traits_[kStrafingDifficulty]; }
+double Mutable::GetMaxSize() const { return traits_[kMaxSize]; }
+double Mutable::GetBabySize() const { return traits_[kBabySize]; }
+double Mutable::GetMaxForce() const { return traits_[kMaxForce]; }
+double Mutable::GetGrowthFactor() const { return traits_[kGrowthFactor]; }
+double Mutable::GetVisionFactor() const { return traits_[kVisionFactor]; }
 double Mutable::GetGestationRatioToIncubation() const {
-  return gestation_ratio_to_incubation_;
+  return traits_[kGestationRatioToIncubation];
 }
 float Mutable::GetColor() const { return color_; }
 double Mutable::GetStomachCapacityFactor() const {
-  return stomach_capacity_factor_;
+  return traits_[kStomachCapacityFactor];
 }
-double Mutable::GetDiet() const { return diet_; };
-double Mutable::GetGeneticStrength() const { return genetic_strength_; };
-double Mutable::GetEatingSpeed() const { return eating_speed_; };
-double Mutable::GetPheromoneEmission() const {return pheromone_emission_;}
+double Mutable::GetDiet() const { return traits_[kDiet]; };
+double Mutable::GetGeneticStrength() const { return traits_[kGeneticStrength]; };
+double Mutable::GetEatingSpeed() const { return traits_[kEatingSpeed]; };
+double Mutable::GetPheromoneEmission() const {return traits_[kPheromoneEmission];}
 
 // Setters
-void Mutable::SetEnergyDensity(double value) { energy_density_ = value; }
-void Mutable::SetEnergyLoss(double value) { energy_loss_ = value; }
-void Mutable::SetIntegrity(double value) { integrity_ = value; }
+void Mutable::SetEnergyDensity(double value) { traits_[kEnergyDensity] = value; }
+void Mutable::SetEnergyLoss(double value) { traits_[kEnergyLoss] = value; }
+void Mutable::SetIntegrity(double value) { traits_[kIntegrity] = value; }
 void Mutable::SetStrafingDifficulty(double value) {
-  strafing_difficulty_ = value;
+  traits_[kStrafingDifficulty] = value;
 }
-void Mutable::SetMaxSize(double value) { max_size_ = value; }
-void Mutable::SetBabySize(double value) { baby_size_ = value; }
-void Mutable::SetMaxForce(double value) { max_force_ = value; }
-void Mutable::SetGrowthFactor(double value) { growth_factor_ = value; }
-void Mutable::SetVisionFactor(double value) { vision_factor_ = value; }
+void Mutable::SetMaxSize(double value) { traits_[kMaxSize] = value; }
+void Mutable::SetBabySize(double value) { traits_[kBabySize] = value; }
+void Mutable::SetMaxForce(double value) { traits_[kMaxForce] = value; }
+void Mutable::SetGrowthFactor(double value) { traits_[kGrowthFactor] = value; }
+void Mutable::SetVisionFactor(double value) { traits_[kVisionFactor] = value; }
 void Mutable::SetGestationRatioToIncubation(double value) {
-  gestation_ratio_to_incubation_ = value;
+  traits_[kGestationRatioToIncubation] = value;
 }
 void Mutable::SetColor(double hue) { color_ = hue; }
 void Mutable::SetStomachCapacityFactor(double value) {
-  stomach_capacity_factor_ = value;
+  traits_[kStomachCapacityFactor] = value;
 }
-void Mutable::SetDiet(double value) { diet_ = value; };
-void Mutable::SetGeneticStrength(double value) { genetic_strength_ = value; };
-void Mutable::SetEatingSpeed(double value) { eating_speed_ = value; };
+void Mutable::SetDiet(double value) { traits_[kDiet] = value; };
+void Mutable::SetGeneticStrength(double value) { traits_[kGeneticStrength] = value; };
+void Mutable::SetEatingSpeed(double value) { traits_[kEatingSpeed] = value; };
 
-void Mutable::SetPheromoneEmission(double value) {pheromone_emission_ = value; }
+void Mutable::SetPheromoneEmission(double value) {traits_[kPheromoneEmission] = value; }
 
 
 /*!
@@ -331,16 +331,8 @@ Mutable MutableCrossover(const Mutable &dominant, const Mutable &recessive) {
  * distance is then scaled by a compatibility factor. A lower distance value
  * indicates higher compatibility.
  *
- * The mutable attributes considered are:
- * - Energy Density
- * - Energy Loss
- * - Integrity
- * - Strafing Difficulty
- * - Max Size
- * - Baby Size
- * - Max Force
- * - Growth Factor
- * - Vision Factor
+ * The traits are stored packed, so every trait but the color is compared
+ * in one vectorised pass.
  *
  * @param other_mutable A constant reference to another `Mutable` object to
  * compare with.
@@ -349,72 +341,32 @@ Mutable MutableCrossover(const Mutable &dominant, const Mutable &recessive) {
  */
 double Mutable::CompatibilityBetweenMutables(
     const Mutable &other_mutable) const {
-  double distance = 0;
-  // Energy Density
-  distance +=
-      fabs(other_mutable.GetEnergyDensity() - this->GetEnergyDensity()) /
-      SETTINGS.physical_constraints.d_energy_density;
-
-  // Energy Loss
-  distance += fabs(other_mutable.GetEnergyLoss() - this->GetEnergyLoss()) /
-              SETTINGS.physical_constraints.d_energy_loss;
-
-  // Integrity
-  distance += fabs(other_mutable.GetIntegrity() - this->GetIntegrity()) /
-              SETTINGS.physical_constraints.d_integrity;
-
-  // Strafing Difficulty
-  distance += fabs(other_mutable.GetStrafingDifficulty() -
-                   this->GetStrafingDifficulty()) /
-              SETTINGS.physical_constraints.d_strafing_difficulty;
-
-  // Max Size
-  distance += fabs(other_mutable.GetMaxSize() - this->GetMaxSize()) /
-              SETTINGS.physical_constraints.d_max_size;
-
-  // Baby Size
-  distance += fabs(other_mutable.GetBabySize() - this->GetBabySize()) /
-              SETTINGS.physical_constraints.d_baby_size;
-
-  // Max Force
-  distance += fabs(other_mutable.GetMaxForce() - this->GetMaxForce()) /
-              SETTINGS.physical_constraints.d_max_force;
+  // scales in the order of the Trait enum
+  const double scales[kTraitCount] = {
+      SETTINGS.physical_constraints.d_energy_density,
+      SETTINGS.physical_constraints.d_energy_loss,
+      SETTINGS.physical_constraints.d_integrity,
+      SETTINGS.physical_constraints.d_strafing_difficulty,
+      SETTINGS.physical_constraints.d_max_size,
+      SETTINGS.physical_constraints.d_baby_size,
+      SETTINGS.physical_constraints.d_max_force,
+      SETTINGS.physical_constraints.d_growth_factor,
+      SETTINGS.physical_constraints.d_vision_factor,
+      SETTINGS.physical_constraints.d_gestation_ratio_to_incubation,
+      SETTINGS.physical_constraints.d_stomach_capacity,
+      SETTINGS.physical_constraints.d_diet,
+      SETTINGS.physical_constraints.d_genetic_strength,
+      SETTINGS.physical_constraints.d_eating_speed,
+      SETTINGS.physical_constraints.d_pheromone_emission};
 
-  // Growth Factor
-  distance += fabs(other_mutable.GetGrowthFactor() - this->GetGrowthFactor()) /
-              SETTINGS.physical_constraints.d_growth_factor;
-
-  // Vision Factor
-  distance += fabs(other_mutable.GetVisionFactor() - this->GetVisionFactor()) /
-              SETTINGS.physical_constraints.d_vision_factor;
-
-  // Gestation Ratio To Incubation
-  distance += fabs(other_mutable.GetGestationRatioToIncubation() -
-                   this->GetGestationRatioToIncubation()) /
-              SETTINGS.physical_constraints.d_gestation_ratio_to_incubation;
+  double distance = 0;
+#pragma omp simd reduction(+ : distance)
+  for (int i = 0; i < kTraitCount; i++) {
+    distance += fabs(other_mutable.traits_[i] - traits_[i]) / scales[i];
+  }
 
   // Color
   distance += fabs(other_mutable.GetColor() - this->GetColor());
 
-  // Stomach Capacity Factor
-  distance += fabs(other_mutable.GetStomachCapacityFactor() - this->GetStomachCapacityFactor())
-              / SETTINGS.physical_constraints.d_stomach_capacity;
-
-  // Diet
-  distance += fabs(other_mutable.GetDiet() - this->GetDiet())
-              / SETTINGS.physical_constraints.d_diet;
-
-  // Genetic Strength
-  distance += fabs(other_mutable.GetGeneticStrength() - this->GetGeneticStrength())
-              / SETTINGS.physical_constraints.d_genetic_strength;
-
-  // Eating Speed
-  distance += fabs(other_mutable.GetEatingSpeed() - this->GetEatingSpeed())
-              / SETTINGS.physical_constraints.d_eating_speed;
-
-  // Pheromone Emission
-  distance += fabs(other_mutable.GetPheromoneEmission() - this->GetPheromoneEmission())
-              / SETTINGS.physical_constraints.d_pheromone_emission;
-
   return distance * SETTINGS.compatibility.mutables_compatibility;
 }
@@ -5,17 +5,17 @@
 
 #include <algorithm>
 
-PheromoneSystem::PheromoneSystem(neat::Genome genome, Mutable mutables)
+PheromoneSystem::PheromoneSystem(const neat::Genome& genome, const Mutable& mutables)
     : AliveEntity(genome, mutables), pheromone_densities_(16, 0),
       pheromone_emissions_(16, 0), pheromone_types_(16,0) {//We use 16 as that is the established number of pheromones avaialable atm
-    for (BrainModule module : genome.GetModules()){
+    for (const BrainModule& module : genome.GetModules()){
         if (module.GetModuleId() == 2){
             pheromone_types_.at(module.GetType()) = 1;
         }
     }
 }
 
-std::vector<double> PheromoneSystem::GetPheromoneDensities(
+ScratchVector<double> PheromoneSystem::GetPheromoneDensities(
         std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
         double GridCellSize) const {
     int x_grid = static_cast<int>(x_coord_ / GridCellSize);
@@ -24,10 +24,11 @@ std::vector<double> PheromoneSystem::GetPheromoneDensities(
     int grid_width = grid.size();
     int grid_height = grid[0].size();
 
-    std::vector<double> pheromone_densities(16, 0);
-    if (std::any_of(pheromone_types_.begin(), pheromone_types_.end(), [](int i){ return i == 1; })) return std::vector<double>(16, 0.0);
-    std::vector<std::pair<int, int>> cells;
+    ScratchVector<double> pheromone_densities(16, 0);
+    if (std::any_of(pheromone_types_.begin(), pheromone_types_.end(), [](int i){ return i == 1; })) return pheromone_densities;
+    ScratchVector<std::pair<int, int>> cells;
     int reach = std::floor(size_/GridCellSize);
+    cells.reserve((2 * reach + 1) * (2 * reach + 1));
     for (int i = -reach; i <= reach; i++){
       for (int j = -reach; j <= reach; j++){
         cells.push_back({(x_grid + i) % grid_width, (y_grid + j) % grid_height});
@@ -51,21 +52,46 @@ std::vector<double> PheromoneSystem::GetPheromoneDensities(
 void PheromoneSystem::ProcessPheromoneDetection(
         std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
         double GridCellSize){
-    pheromone_densities_ = GetPheromoneDensities(grid, GridCellSize);
+    ScratchVector<double> densities = GetPheromoneDensities(grid, GridCellSize);
+    pheromone_densities_.assign(densities.begin(), densities.end());
 }
 
-std::vector<std::shared_ptr<Pheromone>> PheromoneSystem::EmitPheromones(double deltaTime){
-    std::vector<std::shared_ptr<Pheromone>> pheromones;
+/*!
+ * @brief Draws the pheromones emitted this tick, which EmitPheromones then
+ * creates.
+ *
+ * @details Split from their creation so the caller knows how many entities,
+ * hence ids, the creature needs before any is created.
+ *
+ * @param deltaTime The duration of the tick.
+ *
+ * @return The number of pheromones drawn.
+ */
+int PheromoneSystem::DrawPheromones(double deltaTime){
+    pending_pheromones_.clear();
     for (int type = 0; type < 16; type++){
         if (pheromone_emissions_.at(type) > 0){
             if (Random::Double(0.0, 1.0) < pheromone_emissions_.at(type) * size_
                     * SETTINGS.physical_constraints.d_pheromone_emission * deltaTime){
                 double x_coord = x_coord_ + Random::Normal(0.0, 1.0) * size_;
                 double y_coord = y_coord_ + Random::Normal(0.0, 1.0) * size_;
-                double size = std::sqrt(size_);
-                pheromones.push_back(std::make_shared<Pheromone>(Pheromone(type, x_coord, y_coord, size)));
+                pending_pheromones_.push_back({type, x_coord, y_coord, std::sqrt(size_)});
             }
         }
     }
+    return pending_pheromones_.size();
+}
+
+/*!
+ * @brief Creates the pheromones drawn by the last DrawPheromones.
+ */
+ScratchVector<std::shared_ptr<Pheromone>> PheromoneSystem::EmitPheromones(){
+    ScratchVector<std::shared_ptr<Pheromone>> pheromones;
+    pheromones.reserve(pending_pheromones_.size());
+    for (const PendingPheromone& pending : pending_pheromones_){
+        pheromones.push_back(std::make_shared<Pheromone>(
+                pending.type, pending.x_coord, pending.y_coord, pending.size));
+    }
+    pending_pheromones_.clear();
     return pheromones;
 }
@@ -6,7 +6,7 @@
 #include "entity/creature/egg.h"
 #include "core/settings.h"
 
-ReproductiveSystem::ReproductiveSystem(neat::Genome genome, Mutable mutables)
+ReproductiveSystem::ReproductiveSystem(const neat::Genome& genome, const Mutable& mutables)
     : AliveEntity(genome, mutables),
       reproduction_cooldown_(0.0),
       waiting_to_reproduce_(false),
@@ -40,7 +40,7 @@ void ReproductiveSystem::IncreaseOffspringNumber(){ offspring_number_++; }
 
 int ReproductiveSystem::GetOffspringNumber(){return offspring_number_;}
 
-MaleReproductiveSystem::MaleReproductiveSystem(neat::Genome genome, Mutable mutables)
+MaleReproductiveSystem::MaleReproductiveSystem(const neat::Genome& genome, const Mutable& mutables)
     : ReproductiveSystem(genome, mutables),
       AliveEntity(genome, mutables){ //Not really sure why but this is required
   reproduction_cooldown_ = 0;
@@ -56,8 +56,8 @@ void MaleReproductiveSystem::MaleAfterMate() {
     SetEnergy(energy_ - max_energy_ * SETTINGS.environment.male_reproduction_cost);
 }
 
-GestatingEgg::GestatingEgg(neat::Genome genome, Mutable mutables,
-                           int generation)
+GestatingEgg::GestatingEgg(std::shared_ptr<const neat::Genome> genome,
+                           const Mutable& mutables, int generation)
     : genome(genome),
       mutables(mutables),
       generation(generation),
@@ -65,7 +65,7 @@ GestatingEgg::GestatingEgg(neat::Genome genome, Mutable mutables,
       incubation_time(mutables.Complexity() *
                       SETTINGS.environment.egg_incubation_time_multiplier) {}
 
-FemaleReproductiveSystem::FemaleReproductiveSystem(neat::Genome genome, Mutable mutables)
+FemaleReproductiveSystem::FemaleReproductiveSystem(const neat::Genome& genome, const Mutable& mutables)
     : ReproductiveSystem(genome, mutables),
       AliveEntity(genome, mutables), //Not really sure why but this is required
       egg_(),
@@ -85,34 +85,49 @@ void FemaleReproductiveSystem::MateWithMale(const std::shared_ptr<Creature> fath
                                             const std::shared_ptr<Creature> mother) {
   if (not ReadyToProcreate())
     throw std::runtime_error("Not ready to procreate");
+  MateWithMale(Conceive(*father, *mother));
+}
+
+/*!
+ * @brief Starts a pregnancy with an egg conceived beforehand, see Conceive.
+ */
+void FemaleReproductiveSystem::MateWithMale(GestatingEgg egg) {
+  if (not ReadyToProcreate())
+    throw std::runtime_error("Not ready to procreate");
 
   ready_to_reproduce_at_ = std::numeric_limits<double>::max();
+  egg_.emplace(std::move(egg));
+}
 
-  neat::Genome offspring_genome_(0, 0);
-  Mutable offspring_mutable_;
-  int offspring_generation_;
-
-  if (father->GetEnergy() > mother->GetEnergy()) {
-    offspring_genome_ =
-        neat::Crossover(father->GetGenome(), mother->GetGenome());
-    offspring_mutable_ =
-        MutableCrossover(father->GetMutable(), mother->GetMutable());
-    offspring_generation_ = father->GetGeneration() + 1;
-  } else {
-    offspring_genome_ =
-        neat::Crossover(mother->GetGenome(), father->GetGenome());
-    offspring_mutable_ =
-        MutableCrossover(mother->GetMutable(), father->GetMutable());
-    offspring_generation_ = mother->GetGeneration() + 1;
-  }
+/*!
+ * @brief Crosses over and mutates the genomes and mutables of two parents.
+ *
+ * @details The fitter parent, the one with more energy, is dominant. Only
+ * reads the parents, so the conceptions of different pairs can run in
+ * parallel.
+ *
+ * @return The egg the mother will carry.
+ */
+GestatingEgg Conceive(const Creature& father, const Creature& mother) {
+  const Creature& dominant =
+      father.GetEnergy() > mother.GetEnergy() ? father : mother;
+  const Creature& recessive = &dominant == &father ? mother : father;
+
+  neat::Genome offspring_genome_ =
+      neat::Crossover(dominant.GetGenome(), recessive.GetGenome());
+  Mutable offspring_mutable_ =
+      MutableCrossover(dominant.GetMutable(), recessive.GetMutable());
+  int offspring_generation_ = dominant.GetGeneration() + 1;
 
   offspring_genome_.Mutate();
   offspring_genome_.Mutate();
   offspring_mutable_.Mutate();
   offspring_mutable_.Mutate();
 
-  egg_.emplace(offspring_genome_, offspring_mutable_, offspring_generation_);
-};
+  return GestatingEgg(
+      std::make_shared<const neat::Genome>(std::move(offspring_genome_)),
+      offspring_mutable_, offspring_generation_);
+}
 
 bool FemaleReproductiveSystem::CanBirth() const {
   return egg_.has_value() and
@@ -0,0 +1,135 @@
+#include "entity/creature/vision_stencils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+constexpr int kRadiusStepsPerCell = 4;  /*!< Radius and margin lattice. */
+constexpr int kAngleStepsPerTurn = 256; /*!< Vision angle lattice. */
+constexpr double kSlack = 1e-6;         /*!< Covers the cone test epsilon. */
+
+/*!
+ * @brief Whether a square not containing the origin overlaps a cone, by angle
+ * only.
+ *
+ * @param x Centre of the square.
+ * @param y Centre of the square.
+ * @param half Half of the side of the square.
+ * @param orientation Direction of the axis of the cone.
+ * @param half_angle Half of the aperture of the cone.
+ */
+bool OverlapsCone(double x, double y, double half, double orientation,
+                  double half_angle) {
+  const double centre = std::atan2(y, x);
+  double low = 0, high = 0;
+  for (double cx : {x - half, x + half}) {
+    for (double cy : {y - half, y + half}) {
+      double delta = std::remainder(std::atan2(cy, cx) - centre, 2 * M_PI);
+      low = std::min(low, delta);
+      high = std::max(high, delta);
+    }
+  }
+  const double offset = std::remainder(centre - orientation, 2 * M_PI);
+  for (double shift : {-2 * M_PI, 0.0, 2 * M_PI}) {
+    if (offset + shift + low <= half_angle &&
+        offset + shift + high >= -half_angle) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+ * @brief Distance from the origin to the closest point of a square.
+ */
+double DistanceToSquare(double x, double y, double half) {
+  return std::hypot(std::max(std::abs(x) - half, 0.0),
+                    std::max(std::abs(y) - half, 0.0));
+}
+
+}  // namespace
+
+/*!
+ * @brief Returns the stencils of a vision cone, building them on first use.
+ *
+ * @param radius Vision radius, in cells.
+ * @param angle Aperture of the cone, in radians.
+ * @param margin Largest size of an entity seen, in cells.
+ */
+const VisionStencils& VisionStencils::Get(double radius, double angle,
+                                          double margin) {
+  static std::mutex mutex;
+  static std::map<std::tuple<int, int, int>, std::unique_ptr<VisionStencils>>
+      registry;
+
+  const int radius_steps = static_cast<int>(
+      std::ceil((std::max(radius, 0.0) + kSlack) * kRadiusStepsPerCell));
+  const int angle_steps = static_cast<int>(
+      std::ceil((std::clamp(angle, 0.0, 2 * M_PI) + kSlack) *
+                kAngleStepsPerTurn / (2 * M_PI)));
+  const int margin_steps =
+      static_cast<int>(std::ceil(std::max(margin, 0.0) * kRadiusStepsPerCell));
+  const auto key = std::make_tuple(radius_steps, angle_steps, margin_steps);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& stencils = registry[key];
+  if (!stencils) {
+    stencils.reset(new VisionStencils(radius_steps, angle_steps, margin_steps));
+  }
+  return *stencils;
+}
+
+VisionStencils::VisionStencils(int radius_steps, int angle_steps,
+                               int margin_steps)
+    : stencils_(kOrientationBuckets), reach_(0) {
+  const double radius = static_cast<double>(radius_steps) / kRadiusStepsPerCell;
+  const double margin = static_cast<double>(margin_steps) / kRadiusStepsPerCell;
+  const double bucket = 2 * M_PI / kOrientationBuckets;
+  const double half_angle =
+      M_PI * angle_steps / kAngleStepsPerTurn + bucket / 2 + kSlack;
+  // viewer and entity anywhere in their cells, entity disk up to the margin
+  const double half = 1 + margin;
+  const int extent = static_cast<int>(std::ceil(radius + half));
+
+  for (int b = 0; b < kOrientationBuckets; b++) {
+    const double orientation = -M_PI + (b + 0.5) * bucket;
+    Stencil& stencil = stencils_[b];
+    for (int dx = -extent; dx <= extent; dx++) {
+      for (int dy = -extent; dy <= extent; dy++) {
+        if (DistanceToSquare(dx, dy, half) > radius) continue;
+        const bool contains_viewer = std::abs(dx) < half && std::abs(dy) < half;
+        if (!contains_viewer && half_angle < M_PI &&
+            !OverlapsCone(dx, dy, half, orientation, half_angle)) {
+          continue;
+        }
+        stencil.push_back({dx, dy, DistanceToSquare(dx, dy, 1)});
+        reach_ = std::max({reach_, std::abs(dx), std::abs(dy)});
+      }
+    }
+    std::stable_sort(stencil.begin(), stencil.end(),
+                     [](const StencilCell& a, const StencilCell& b) {
+                       return a.min_distance < b.min_distance;
+                     });
+  }
+}
+
+/*!
+ * @brief The stencil of the bucket of an orientation.
+ */
+const Stencil& VisionStencils::ForOrientation(double orientation) const {
+  const double turn = std::remainder(orientation, 2 * M_PI) + M_PI;
+  int b = static_cast<int>(turn * kOrientationBuckets / (2 * M_PI));
+  return stencils_[std::clamp(b, 0, kOrientationBuckets - 1)];
+}
+
+/*!
+ * @brief Whether a stencil can visit a cell twice on a wrapping grid.
+ */
+bool VisionStencils::MayWrap(int columns, int rows) const {
+  return 2 * reach_ + 1 > columns || 2 * reach_ + 1 > rows;
+}
@@ -1,10 +1,72 @@
 #include "entity/creature/vision_system.h"
 #include "entity/creature/pheromone.h"
+#include "entity/creature/egg.h"
 #include "core/settings.h"
-#include <queue>
-#include <set>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-VisionSystem::VisionSystem(neat::Genome genome, Mutable mutables)
+namespace {
+
+/*! An entity in sight and its distance to the creature. */
+using Candidate = std::pair<double, const std::shared_ptr<Entity>*>;
+
+bool CompareCandidates(const Candidate& a, const Candidate& b) {
+  return a.first < b.first;
+}
+
+/*!
+ * @brief Summary of the entities in a cell, independent of their order: the
+ * sum of their mixed ids. Ids are never reused, so a different set gives a
+ * different signature but for a 2^-64 chance.
+ */
+std::uint64_t CellSignature(const std::vector<std::shared_ptr<Entity>>& cell) {
+  std::uint64_t signature = 0;
+  for (const auto& entity : cell) {
+    if (!entity) continue;
+    std::uint64_t id = entity->GetID() + 0x9E3779B97F4A7C15ULL;
+    id = (id ^ (id >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    id = (id ^ (id >> 27)) * 0x94D049BB133111EBULL;
+    signature += id ^ (id >> 31);
+  }
+  return signature;
+}
+
+/*!
+ * @brief Distance along a ray to the first point of a disk, or -1 if the ray
+ * misses it.
+ *
+ * @param dx Offset of the centre of the disk from the origin of the ray.
+ * @param dy Offset of the centre of the disk from the origin of the ray.
+ * @param cos_a Unit direction of the ray.
+ * @param sin_a Unit direction of the ray.
+ * @param radius Radius of the disk.
+ */
+double RayDiskDistance(double dx, double dy, double cos_a, double sin_a,
+                       double radius) {
+  const double along = dx * cos_a + dy * sin_a;
+  const double across = dx * sin_a - dy * cos_a;
+  if (std::abs(across) > radius) return -1;
+  const double half_chord = std::sqrt(radius * radius - across * across);
+  if (along + half_chord < 0) return -1;
+  return std::max(along - half_chord, 0.0);
+}
+
+/*!
+ * @brief Kind of an entity, as reported by the ray-cast vision module.
+ */
+VisionSystem::RayHit KindOf(const Entity& entity) {
+  if (auto food = dynamic_cast<const Food*>(&entity)) {
+    return food->GetType() == Food::meat ? VisionSystem::kMeat
+                                         : VisionSystem::kPlant;
+  }
+  if (dynamic_cast<const Egg*>(&entity)) return VisionSystem::kEgg;
+  return VisionSystem::kCreature;
+}
+
+}  // namespace
+
+VisionSystem::VisionSystem(const neat::Genome& genome, const Mutable& mutables)
     : AliveEntity(genome, mutables),
       vision_radius_(mutables.GetVisionFactor()),
       vision_angle_(SETTINGS.physical_constraints.vision_ar_ratio
@@ -17,7 +79,7 @@ VisionSystem::VisionSystem(neat::Genome genome, Mutable mutables)
       closest_entity_(nullptr)
 {
   number_entities_to_return_ = 1;
-  for(BrainModule module : genome.GetModules()){
+  for(const BrainModule& module : genome.GetModules()){
     if (module.GetModuleId() == 3){
       number_entities_to_return_++;
     }
@@ -49,73 +111,235 @@ double VisionSystem::GetVisionAngle() const { return vision_angle_; }
 double VisionSystem::GetEntityCompatibility() const { return entity_compatibility_; }
 
 
-std::vector<std::shared_ptr<Entity>> VisionSystem::GetClosestEntitiesInSight(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+/*!
+ * @brief Finds the entities in the vision cone closest to the creature.
+ *
+ * @details Scans the cells of the precomputed stencil of the cone, see
+ * VisionStencils, nearest first, keeping the nearest candidates in a small
+ * max-heap. The scan stops once no remaining cell can hold an entity closer
+ * than the farthest one kept. The cone boundaries are computed once per
+ * query. Pheromones are not seen.
+ *
+ * Creatures move little between thinks, so the result and the cells scanned
+ * are kept. While the creature stays in the same cell, with the same
+ * stencil and close to where the last full scan happened, a query only
+ * re-checks the previous entities and rescans the cells whose set of entities
+ * changed, told by CellSignature. Entities moving within unchanged cells are
+ * then only noticed by
+ * the full scan done every SETTINGS.engine.vision_refresh_interval queries,
+ * or as soon as one of the previous entities leaves the cone.
+ *
+ * @return number_entities_to_return_ entities sorted by distance, padded
+ * with nullptr.
+ */
+ScratchVector<std::shared_ptr<Entity>> VisionSystem::GetClosestEntitiesInSight(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
                                               double grid_cell_size, double map_width, double map_heigth) const
 {
-    int grid_width = grid.size();
-    int grid_height = grid[0].size();
-
-    int x_grid = static_cast<int>(x_coord_ / grid_cell_size);
-    int y_grid = static_cast<int>(y_coord_ / grid_cell_size);
-
-    int max_cells_to_find_food = M_PI * pow(vision_radius_ + 2 * sqrt(2) * grid_cell_size + SETTINGS.environment.max_food_size, 2) / (grid_cell_size * grid_cell_size);
-
-    auto cone_center = Point(x_coord_, y_coord_);
-    auto cone_orientation = GetOrientation();
-    auto cone_left_boundary = OrientedAngle(cone_orientation - vision_angle_ / 2);
-    auto cone_right_boundary = OrientedAngle(cone_orientation + vision_angle_ / 2);
-
-    std::vector<std::shared_ptr<Entity>> found_entities;
-    found_entities.reserve(number_entities_to_return_);
+    const int grid_width = grid.size();
+    const int grid_height = grid[0].size();
+    const int k = number_entities_to_return_;
+
+    const double margin = std::max(SETTINGS.environment.max_food_size,
+                                   SETTINGS.environment.max_creature_size);
+    if (!stencils_ || stencil_key_[0] != vision_radius_ ||
+        stencil_key_[1] != vision_angle_ || stencil_key_[2] != grid_cell_size) {
+      stencils_ = &VisionStencils::Get(vision_radius_ / grid_cell_size,
+                                       vision_angle_, margin / grid_cell_size);
+      stencil_key_ = {vision_radius_, vision_angle_, grid_cell_size};
+      vision_cache_.valid = false;
+    }
+    const Stencil& stencil = stencils_->ForOrientation(GetOrientation());
+
+    const Cone cone = GetVisionCone();
+    const int x_grid = std::clamp(static_cast<int>(x_coord_ / grid_cell_size), 0, grid_width - 1);
+    const int y_grid = std::clamp(static_cast<int>(y_coord_ / grid_cell_size), 0, grid_height - 1);
+
+    // max-heap on distance of the k nearest entities found so far
+    ScratchVector<Candidate> nearest;
+    nearest.reserve(k + 1);
+    bool deduplicate = stencils_->MayWrap(grid_width, grid_height);
+    auto consider = [&](const std::shared_ptr<Entity>& entity) {
+      if (!entity || entity.get() == this ||
+          !IsInVisionCone(cone, *entity, map_width, map_heigth) ||
+          dynamic_cast<const Pheromone*>(entity.get())) {
+        return false;
+      }
+      const double distance =
+          Point(entity->GetCoordinates()).dist(cone.center, map_width, map_heigth);
+      if (nearest.size() == k && distance >= nearest.front().first) return true;
+      if (deduplicate &&
+          std::any_of(nearest.begin(), nearest.end(), [&](const Candidate& c) {
+            return c.second->get() == entity.get();
+          })) {
+        return true;
+      }
+      nearest.emplace_back(distance, &entity);
+      std::push_heap(nearest.begin(), nearest.end(), CompareCandidates);
+      if (nearest.size() > k) {
+        std::pop_heap(nearest.begin(), nearest.end(), CompareCandidates);
+        nearest.pop_back();
+      }
+      return true;
+    };
+
+    VisionCache& cache = vision_cache_;
+    const bool incremental =
+        cache.valid && cache.stencil == &stencil && cache.x_grid == x_grid &&
+        cache.y_grid == y_grid &&
+        cache.age + 1 < SETTINGS.engine.vision_refresh_interval &&
+        Point(x_coord_, y_coord_).dist(Point(cache.x, cache.y), map_width, map_heigth) <=
+            grid_cell_size / 4;
+    ScratchVector<std::shared_ptr<Entity>> previous;
+    bool rescan = !incremental;
+    if (incremental) {
+      // the entities seen last time may now sit in any cell
+      deduplicate = true;
+      previous.reserve(cache.entities.size());
+      for (const auto& seen : cache.entities) {
+        std::shared_ptr<Entity> entity = seen.lock();
+        if (!entity || entity->GetState() != Entity::Alive) {
+          rescan = true;
+          break;
+        }
+        previous.push_back(std::move(entity));
+      }
+      cache.entities.clear();
+      // the candidates point into previous, which is complete by now
+      for (int i = 0; !rescan && i < previous.size(); ++i) {
+        if (!consider(previous[i])) rescan = true;
+      }
+    }
 
-    std::queue<std::pair<int, int>> cells_queue;
-    std::set<std::pair<int, int>> visited_cells;
+    if (rescan) {
+      nearest.clear();
+      deduplicate = stencils_->MayWrap(grid_width, grid_height);
+      cache.cells.clear();
+      cache.stencil_end = 0;
+      cache.age = 0;
+      cache.x = x_coord_;
+      cache.y = y_coord_;
+    } else {
+      cache.age++;
+      for (ScannedCell& cell : cache.cells) {
+        const auto& entities = grid[cell.x][cell.y];
+        const std::uint64_t signature = CellSignature(entities);
+        if (signature == cell.signature) continue;
+        cell.signature = signature;
+        for (const auto& entity : entities) consider(entity);
+      }
+    }
 
-    cells_queue.push({x_grid, y_grid});
-    visited_cells.insert({x_grid, y_grid});
+    for (; cache.stencil_end < stencil.size(); cache.stencil_end++) {
+      const StencilCell& cell = stencil[cache.stencil_end];
+      if (nearest.size() == k &&
+          cell.min_distance * grid_cell_size >= nearest.front().first) {
+        break;
+      }
+      const int x = ((x_grid + cell.dx) % grid_width + grid_width) % grid_width;
+      const int y = ((y_grid + cell.dy) % grid_height + grid_height) % grid_height;
+      cache.cells.push_back({x, y, CellSignature(grid[x][y])});
+      for (const auto& entity : grid[x][y]) consider(entity);
+    }
 
-    size_t processed_cells = 0;
+    std::sort_heap(nearest.begin(), nearest.end(), CompareCandidates);
+    ScratchVector<std::shared_ptr<Entity>> found_entities(k, nullptr);
+    for (int i = 0; i < nearest.size(); ++i) {
+      found_entities[i] = *nearest[i].second;
+    }
 
-    while (!cells_queue.empty()) {
-      auto [x, y] = cells_queue.front();
-      cells_queue.pop();
-      ++processed_cells;
+    cache.valid = SETTINGS.engine.vision_refresh_interval > 1;
+    cache.stencil = &stencil;
+    cache.x_grid = x_grid;
+    cache.y_grid = y_grid;
+    cache.entities.assign(found_entities.begin(),
+                          found_entities.begin() + nearest.size());
+    return found_entities;
+}
 
-      for (auto entity : grid[x][y]) {
-        if (entity &&  entity.get() != this && IsInVisionCone(entity, map_width, map_heigth)) {
-          std::shared_ptr<Pheromone> pheromone_entity = std::dynamic_pointer_cast<Pheromone>(entity);
 
-            if (!pheromone_entity) {
-            found_entities.push_back(entity);
-            if (found_entities.size() == number_entities_to_return_) {
-              break;
-            }
+/*!
+ * @brief Casts the rays of the ray-cast vision module.
+ *
+ * @details The rays are spread evenly over the vision cone. Each ray walks the
+ * grid cell by cell with a DDA (Amanatides-Woo) traversal, wrapping around the
+ * map borders, and stops at the first cell holding an entity it hits, so its
+ * cost grows with the distance to that entity rather than with the area of the
+ * cone. Entities are looked up in the cell of their centre, as they are stored
+ * in the grid. Pheromones and the creature itself are transparent.
+ *
+ * @param grid The environmental grid.
+ * @param grid_cell_size Size of each cell in the grid.
+ * @param map_width Width of the map.
+ * @param map_heigth Height of the map.
+ * @param rays Number of rays.
+ * @param out Written with 3 values per ray: the distance to the first hit, or
+ * the vision radius if nothing is hit, its RayHit kind and its color.
+ */
+void VisionSystem::CastRays(std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &grid,
+                            double grid_cell_size, double map_width, double map_heigth,
+                            int rays, double* out) const
+{
+    const int grid_width = grid.size();
+    const int grid_height = grid[0].size();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double reach = vision_radius_ / grid_cell_size;
+    const double origin_x = x_coord_ / grid_cell_size;
+    const double origin_y = y_coord_ / grid_cell_size;
+
+    for (int r = 0; r < rays; r++) {
+      const double angle = GetOrientation() - vision_angle_ / 2 +
+                           vision_angle_ * (r + 0.5) / rays;
+      const double cos_a = std::cos(angle);
+      const double sin_a = std::sin(angle);
+
+      int cell_x = static_cast<int>(std::floor(origin_x));
+      int cell_y = static_cast<int>(std::floor(origin_y));
+      const int step_x = cos_a > 0 ? 1 : -1;
+      const int step_y = sin_a > 0 ? 1 : -1;
+      const double delta_x = cos_a != 0 ? std::abs(1 / cos_a) : infinity;
+      const double delta_y = sin_a != 0 ? std::abs(1 / sin_a) : infinity;
+      double next_x = cos_a != 0
+          ? (cell_x + (step_x > 0) - origin_x) / cos_a : infinity;
+      double next_y = sin_a != 0
+          ? (cell_y + (step_y > 0) - origin_y) / sin_a : infinity;
+
+      double hit_distance = vision_radius_;
+      const Entity* hit = nullptr;
+      for (double entry = 0; entry <= reach;) {
+        const int x = (cell_x % grid_width + grid_width) % grid_width;
+        const int y = (cell_y % grid_height + grid_height) % grid_height;
+        for (const auto& entity : grid[x][y]) {
+          if (!entity || entity.get() == this ||
+              dynamic_cast<const Pheromone*>(entity.get())) {
+            continue;
           }
-        }
-      }
-      if (found_entities.size() == number_entities_to_return_ || processed_cells > max_cells_to_find_food) {
-        break;
-      }
-
-      for (int dx = -1; dx <= 1; ++dx) {
-        for (int dy = -1; dy <= 1; ++dy) {
-          if (dx * dx + dy * dy != 1) continue;
-          int nx = x + dx, ny = y + dy;
-          if (0 <= nx && nx < grid_width && 0 <= ny && ny < grid_height && !visited_cells.count({nx, ny})) {
-            if (IsGridCellPotentiallyInsideCone(
-                    Point(nx * grid_cell_size, ny * grid_cell_size),
-                    grid_cell_size, cone_center, vision_radius_,
-                    cone_left_boundary, cone_right_boundary,
-                    map_width, map_heigth)) {
-              visited_cells.insert({nx, ny});
-              cells_queue.push({nx, ny});
-            }
+          const auto [entity_x, entity_y] = entity->GetCoordinates();
+          const double distance = RayDiskDistance(
+              std::remainder(entity_x - x_coord_, map_width),
+              std::remainder(entity_y - y_coord_, map_heigth),
+              cos_a, sin_a, entity->GetSize());
+          if (distance >= 0 && distance <= hit_distance) {
+            hit_distance = distance;
+            hit = entity.get();
           }
         }
+        if (hit) break;
+
+        if (next_x < next_y) {
+          entry = next_x;
+          next_x += delta_x;
+          cell_x += step_x;
+        } else {
+          entry = next_y;
+          next_y += delta_y;
+          cell_y += step_y;
+        }
       }
+
+      out[3 * r] = hit_distance;
+      out[3 * r + 1] = hit ? KindOf(*hit) : kNothing;
+      out[3 * r + 2] = hit ? hit->GetColor() : 0;
     }
-    found_entities.resize(number_entities_to_return_, nullptr);
-    return found_entities;
 }
 
 
@@ -134,12 +358,30 @@ bool VisionSystem::IsInRightDirection(std::shared_ptr<Entity> entity, double map
 
 bool VisionSystem::IsInVisionCone(std::shared_ptr<Entity> entity, double map_width, double map_heigth) const
 {
-  auto cone_center = Point(x_coord_, y_coord_);
+  return IsInVisionCone(GetVisionCone(), *entity, map_width, map_heigth);
+}
+
+/*!
+ * @brief The vision cone of the creature at its current position.
+ */
+VisionSystem::Cone VisionSystem::GetVisionCone() const
+{
   auto cone_orientation = GetOrientation();
-  auto cone_left_boundary = OrientedAngle(cone_orientation - vision_angle_ / 2);
-  auto cone_right_boundary = OrientedAngle(cone_orientation + vision_angle_ / 2);
+  return {Point(x_coord_, y_coord_),
+          OrientedAngle(cone_orientation - vision_angle_ / 2),
+          OrientedAngle(cone_orientation + vision_angle_ / 2)};
+}
 
-  auto entity_point = Point(entity->GetCoordinates());
+/*!
+ * @brief Whether an entity, or part of it, is inside a precomputed cone.
+ */
+bool VisionSystem::IsInVisionCone(const Cone& cone, const Entity& entity, double map_width, double map_heigth) const
+{
+  const auto& cone_center = cone.center;
+  const auto& cone_left_boundary = cone.left_boundary;
+  const auto& cone_right_boundary = cone.right_boundary;
+
+  auto entity_point = Point(entity.GetCoordinates());
 
   auto food_direction = OrientedAngle(cone_center, entity_point, map_width, map_heigth);
 
@@ -147,11 +389,11 @@ bool VisionSystem::IsInVisionCone(std::shared_ptr<Entity> entity, double map_wid
 
   bool is_in_field_of_view = (food_direction.IsInsideCone(cone_left_boundary, cone_right_boundary));
 
-  bool is_on_edge = (food_direction.AngleDistanceToCone(cone_left_boundary, cone_right_boundary) <= M_PI/2) && (distance * sin(food_direction.AngleDistanceToCone(cone_left_boundary, cone_right_boundary)) <= entity->GetSize() + SETTINGS.engine.eps);
+  bool is_on_edge = (food_direction.AngleDistanceToCone(cone_left_boundary, cone_right_boundary) <= M_PI/2) && (distance * sin(food_direction.AngleDistanceToCone(cone_left_boundary, cone_right_boundary)) <= entity.GetSize() + SETTINGS.engine.eps);
 
   if (is_in_field_of_view) {
     bool is_within_vision_radius =
-        distance <= vision_radius_ + entity->GetSize() + SETTINGS.engine.eps;
+        distance <= vision_radius_ + entity.GetSize() + SETTINGS.engine.eps;
     if (is_within_vision_radius) { return true; }
   }
 
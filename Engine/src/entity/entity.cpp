@@ -2,21 +2,20 @@
 
 #include <cassert>
 #include <cmath>
+#include "core/id_service.h"
 #include "core/random.h"
 #include "core/settings.h"
 
 #include "simulation/environment.h"
 #include "core/geometry_primitives.h"
 
-int Entity::next_id_ = 0;
-
 /*!
  * @brief Default constructor initializing an Entity at the origin with zero
  * size.
  */
 Entity::Entity() : x_coord_(0.0), y_coord_(0.0),
     size_(0.0), state_(Alive), orientation_(0),
-    id_(next_id_++), color_hue_(0) {}
+    id_(IdService::Next(IdService::kEntity)), color_hue_(0) {}
 
 
 /*!
@@ -33,7 +32,7 @@ Entity::Entity(const double x_coord, const double y_coord, const double size)
       size_(size),
       orientation_(0),
       state_(Alive),
-      id_(next_id_++),
+      id_(IdService::Next(IdService::kEntity)),
       color_hue_(0) {
     orientation_ = Random::Double(0.0, 2*M_PI);
 }
@@ -49,7 +48,7 @@ Entity::Entity(const double size)
       size_(size),
       orientation_(0),
       state_(Alive),
-      id_(next_id_++),
+      id_(IdService::Next(IdService::kEntity)),
       color_hue_(0) {}
 
 /*!
@@ -223,7 +222,7 @@ void Entity::SetState(Entity::states state) { state_ = state; }
 void Entity::OnCollision(std::shared_ptr<Entity> other_entity, double const kMapWidth,
                          double const kMapHeight) { }
 
-int Entity::GetID() const {
+std::int64_t Entity::GetID() const {
   return id_;
 }
 
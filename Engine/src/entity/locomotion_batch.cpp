@@ -0,0 +1,124 @@
+#include "entity/locomotion_batch.h"
+
+#include <cmath>
+
+#include "core/thread_pool.h"
+
+/*!
+ * @brief Removes every queued entity, keeping the buffers for the next step.
+ */
+void LocomotionBatch::Clear() { entities_.clear(); }
+
+/*!
+ * @brief Queues an entity for the next call to Step.
+ */
+void LocomotionBatch::Add(MovableEntity &entity) {
+  entities_.push_back(&entity);
+}
+
+int LocomotionBatch::GetSize() const { return entities_.size(); }
+
+/*!
+ * @brief Computes the next motion state of every queued entity, without
+ * writing it to the entities.
+ *
+ * @details Same model as UpdateVelocities, then Move, then Rotate: in the frame
+ * of the entity v += (a - k (1 + s |v_y| / |v|) v) dt, the position advances
+ * by the new velocity turned by the old orientation and the orientation by the
+ * new rotational velocity.
+ *
+ * @param delta_time The time interval of the step.
+ * @param map_width Width of the map for wrapping around.
+ * @param map_height Height of the map for wrapping around.
+ */
+void LocomotionBatch::Integrate(double delta_time, double map_width,
+                                double map_height) {
+  const int n = entities_.size();
+  for (auto *lane : {&x_, &y_, &orientation_, &velocity_x_, &velocity_y_,
+                     &rotational_velocity_, &acceleration_,
+                     &acceleration_angle_, &rotational_acceleration_,
+                     &friction_, &strafing_, &rotational_friction_}) {
+    lane->resize(n);
+  }
+
+  ThreadPool::Global().ParallelFor(0, n, [&](int i) {
+    const MovableEntity &entity = *entities_[i];
+    x_[i] = entity.x_coord_;
+    y_[i] = entity.y_coord_;
+    orientation_[i] = entity.orientation_;
+    velocity_x_[i] = entity.velocity_x_;
+    velocity_y_[i] = entity.velocity_y_;
+    rotational_velocity_[i] = entity.rotational_velocity_;
+    acceleration_[i] = entity.acceleration_;
+    acceleration_angle_[i] = entity.acceleration_angle_;
+    rotational_acceleration_[i] = entity.rotational_acceleration_;
+    friction_[i] =
+        std::sqrt(std::abs(entity.size_)) * entity.frictional_coefficient_;
+    strafing_[i] = entity.strafing_difficulty_;
+    rotational_friction_[i] = entity.size_ * entity.frictional_coefficient_;
+  });
+
+  double *x = x_.data(), *y = y_.data(), *orientation = orientation_.data();
+  double *velocity_x = velocity_x_.data(), *velocity_y = velocity_y_.data();
+  double *rotational_velocity = rotational_velocity_.data();
+  const double *acceleration = acceleration_.data();
+  const double *acceleration_angle = acceleration_angle_.data();
+  const double *rotational_acceleration = rotational_acceleration_.data();
+  const double *friction = friction_.data(), *strafing = strafing_.data();
+  const double *rotational_friction = rotational_friction_.data();
+  const double dt = delta_time;
+
+  ThreadPool::Global().ParallelForRange(0, n, [&](int begin, int end) {
+#pragma omp simd
+    for (int i = begin; i < end; i++) {
+      double vx = velocity_x[i], vy = velocity_y[i];
+      const double speed = std::sqrt(vx * vx + vy * vy);
+      const double strafe = speed > 0 ? std::abs(vy) / speed : 0.0;
+      const double k = friction[i] * (1 + strafing[i] * strafe);
+      vx += (acceleration[i] * std::cos(acceleration_angle[i]) - k * vx) * dt;
+      vy += (acceleration[i] * std::sin(acceleration_angle[i]) - k * vy) * dt;
+      const double w =
+          rotational_velocity[i] +
+          (rotational_acceleration[i] - rotational_friction[i] *
+                                            rotational_velocity[i]) * dt;
+
+      const double cos_o = std::cos(orientation[i]);
+      const double sin_o = std::sin(orientation[i]);
+      double new_x =
+          std::fmod(x[i] + (cos_o * vx - sin_o * vy) * dt, map_width);
+      double new_y =
+          std::fmod(y[i] + (sin_o * vx + cos_o * vy) * dt, map_height);
+      x[i] = new_x < 0 ? new_x + map_width : new_x;
+      y[i] = new_y < 0 ? new_y + map_height : new_y;
+      orientation[i] = std::remainder(orientation[i] + w * dt, 2 * M_PI);
+      velocity_x[i] = vx;
+      velocity_y[i] = vy;
+      rotational_velocity[i] = w;
+    }
+  });
+}
+
+/*!
+ * @brief Writes the state computed by Integrate to the queued entities.
+ */
+void LocomotionBatch::Swap() {
+  const int n = entities_.size();
+  ThreadPool::Global().ParallelFor(0, n, [&](int i) {
+    MovableEntity &entity = *entities_[i];
+    entity.x_coord_ = x_[i];
+    entity.y_coord_ = y_[i];
+    entity.orientation_ = orientation_[i];
+    entity.velocity_x_ = velocity_x_[i];
+    entity.velocity_y_ = velocity_y_[i];
+    entity.rotational_velocity_ = rotational_velocity_[i];
+  });
+}
+
+/*!
+ * @brief Moves and rotates every queued entity, Integrate then Swap.
+ */
+void LocomotionBatch::Step(double delta_time, double map_width,
+                           double map_height) {
+  Integrate(delta_time, map_width, map_height);
+  Swap();
+}
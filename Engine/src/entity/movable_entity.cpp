@@ -1,5 +1,7 @@
 #include "entity/movable_entity.h"
 
+#include <cmath>
+
 #include "core/settings.h"
 #include "math.h"
 #include "core/geometry_primitives.h"
@@ -28,8 +30,8 @@ MovableEntity::MovableEntity()
       acceleration_(0),
       acceleration_angle_(0),
       rotational_acceleration_(0),
-      velocity_(0),
-      velocity_angle_(0),
+      velocity_x_(0),
+      velocity_y_(0),
       rotational_velocity_(0),
       strafing_difficulty_(0.5),
       frictional_coefficient_(SETTINGS.environment.frictional_coefficient){}
@@ -56,12 +58,16 @@ double MovableEntity::GetRotationalAcceleration() const {
 /*!
  * @brief Returns the linear velocity.
  */
-double MovableEntity::GetVelocity() const { return velocity_; }
+double MovableEntity::GetVelocity() const {
+  return std::hypot(velocity_x_, velocity_y_);
+}
 
 /*!
- * @brief Returns the angle of velocity.
+ * @brief Returns the angle of velocity, 0 at rest.
  */
-double MovableEntity::GetVelocityAngle() const { return velocity_angle_; }
+double MovableEntity::GetVelocityAngle() const {
+  return std::atan2(velocity_y_, velocity_x_);
+}
 
 /*!
  * @brief Returns the rotational velocity.
@@ -102,14 +108,22 @@ void MovableEntity::SetRotationalAcceleration(double rotational_acceleration) {
  *
  * @param velocity The new linear velocity value.
  */
-void MovableEntity::SetVelocity(double velocity) { velocity_ = velocity; }
+void MovableEntity::SetVelocity(double velocity) {
+  const double angle = GetVelocityAngle();
+  velocity_x_ = velocity * std::cos(angle);
+  velocity_y_ = velocity * std::sin(angle);
+}
 
 /*!
- * @brief Sets the angle of the linear velocity.
+ * @brief Sets the angle of the linear velocity, keeping its magnitude.
  *
  * @param angle The new angle for the linear velocity, measured in radians.
  */
-void MovableEntity::SetVelocityAngle(double angle) { velocity_angle_ = angle; }
+void MovableEntity::SetVelocityAngle(double angle) {
+  const double velocity = GetVelocity();
+  velocity_x_ = velocity * std::cos(angle);
+  velocity_y_ = velocity * std::sin(angle);
+}
 
 /*!
  * @brief Sets the rotational velocity of the entity.
@@ -189,27 +203,22 @@ double MovableEntity::GetEffectiveRotationalAcceleration() const {
  * @brief Updates the velocities (linear and rotational) based on acceleration,
  * friction, and time.
  *
+ * @details The effective acceleration is the acceleration minus the forward
+ * friction, which opposes the velocity, so in the frame of the entity
+ * v += (a - k v) dt with k = GetForwardFriction() / |v|. No angle is needed.
+ *
  * @param deltaTime The time interval over which to update the velocities.
  */
 void MovableEntity::UpdateVelocities(double deltaTime) {
-  // Get absolute x and y components of velocity
-  double velocity_x =
-      GetVelocity() * cos(GetOrientation() + GetVelocityAngle());
-  double velocity_y =
-      GetVelocity() * sin(GetOrientation() + GetVelocityAngle());
-
-  // update absolute x and y components of velocity
-  velocity_x += GetEffectiveForwardAcceleration() *
-                cos(GetOrientation() + GetEffectiveAccelerationAngle()) *
-                deltaTime;
-  velocity_y += GetEffectiveForwardAcceleration() *
-                sin(GetOrientation() + GetEffectiveAccelerationAngle()) *
-                deltaTime;
-  // update velocity
-  SetVelocity(sqrt(pow(velocity_x, 2) + pow(velocity_y, 2)));
-  // update velocity angle
-  SetVelocityAngle(atan2(velocity_y, velocity_x) - GetOrientation());
-  // update rotational velocity
+  const double speed = GetVelocity();
+  const double strafing = speed > 0 ? std::abs(velocity_y_) / speed : 0;
+  const double friction = std::sqrt(std::abs(GetSize())) *
+                          frictional_coefficient_ *
+                          (1 + strafing_difficulty_ * strafing);
+  velocity_x_ += (acceleration_ * std::cos(acceleration_angle_) -
+                  friction * velocity_x_) * deltaTime;
+  velocity_y_ += (acceleration_ * std::sin(acceleration_angle_) -
+                  friction * velocity_y_) * deltaTime;
   SetRotationalVelocity(GetRotationalVelocity() +
                         GetEffectiveRotationalAcceleration() * deltaTime);
 }
@@ -224,20 +233,16 @@ void MovableEntity::UpdateVelocities(double deltaTime) {
  */
 void MovableEntity::Move(double deltaTime, const double kMapWidth,
                          const double kMapHeight) {
-  double orientation = GetOrientation();
+  double cos_o = cos(GetOrientation());
+  double sin_o = sin(GetOrientation());
 
-  double delta_x =
-      GetVelocity() * cos(orientation + velocity_angle_) * deltaTime;
-  double delta_y =
-      GetVelocity() * sin(orientation + velocity_angle_) * deltaTime;
+  // velocity from the frame of the entity to the map
+  double delta_x = (cos_o * velocity_x_ - sin_o * velocity_y_) * deltaTime;
+  double delta_y = (sin_o * velocity_x_ + cos_o * velocity_y_) * deltaTime;
 
-  // Update position
   auto [current_x, current_y] = GetCoordinates();
-  double new_x = current_x + delta_x;
-
-  double new_y = fmod(current_y + delta_y, kMapHeight);
-
-  SetCoordinates(new_x, new_y, kMapWidth, kMapHeight);
+  SetCoordinates(current_x + delta_x, current_y + delta_y, kMapWidth,
+                 kMapHeight);
 }
 
 /*!
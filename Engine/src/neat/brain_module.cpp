@@ -9,7 +9,7 @@ BrainModule::BrainModule(int input, int output, int module_id, bool multiple)
     type_ = Random::Int(0, 15);
 }
 
-BrainModule::BrainModule(int first_input_index, int first_output_index, const std::vector<int>& input_neuron_ids, const std::vector<int>& output_neuron_ids, int module_id, bool multiple, int type)
+BrainModule::BrainModule(int first_input_index, int first_output_index, const std::vector<std::int64_t>& input_neuron_ids, const std::vector<std::int64_t>& output_neuron_ids, int module_id, bool multiple, int type)
     : first_input_index_(first_input_index), first_output_index_(first_output_index), input_neuron_ids_(input_neuron_ids), output_neuron_ids_(output_neuron_ids), module_id_(module_id),
     multiple_(multiple), type_(type) {
 
@@ -31,19 +31,19 @@ void BrainModule::SetFirstOutputIndex(const int index) {
     first_output_index_ = index;
 }
 
-std::vector<int> BrainModule::GetInputNeuronIds() const {
+std::vector<std::int64_t> BrainModule::GetInputNeuronIds() const {
     return input_neuron_ids_;
 }
 
-void BrainModule::SetInputNeuronIds(const std::vector<int> input_neuron_ids) {
+void BrainModule::SetInputNeuronIds(const std::vector<std::int64_t> input_neuron_ids) {
     input_neuron_ids_ = input_neuron_ids;
 }
 
-std::vector<int> BrainModule::GetOutputNeuronIds() const {
+std::vector<std::int64_t> BrainModule::GetOutputNeuronIds() const {
     return output_neuron_ids_;
 }
 
-void BrainModule::SetOutputNeuronIds(const std::vector<int> output_neuron_ids) {
+void BrainModule::SetOutputNeuronIds(const std::vector<std::int64_t> output_neuron_ids) {
     output_neuron_ids_ = output_neuron_ids;
 }
 
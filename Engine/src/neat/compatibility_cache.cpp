@@ -0,0 +1,167 @@
+#include "neat/compatibility_cache.h"
+/*!
+ * @file compatibility_cache.cpp
+ *
+ * @brief Implements the memo of genome compatibility distances.
+ */
+
+#include <algorithm>
+
+#include "core/settings.h"
+
+namespace neat {
+
+std::size_t CompatibilityCache::KeyHash::operator()(const Key &key) const {
+  std::size_t h = key.first * 0x9e3779b97f4a7c15ULL;
+  return h ^ (key.second + 0x7f4a7c159e3779b9ULL + (h << 6) + (h >> 2));
+}
+
+/*!
+ * @brief Whether the slot was filled for these genomes, or for equal ones.
+ * The caller holds the shard lock.
+ */
+bool CompatibilityCache::Slot::Holds(const Genome &a, const Genome &b) const {
+  auto same = [](const std::weak_ptr<const Genome> &stored,
+                 const Genome &genome) {
+    std::shared_ptr<const Genome> held = stored.lock();
+    return held && (held.get() == &genome || *held == genome);
+  };
+  if (same(first, a) && same(second, b)) return true;
+  // equal hashes leave the order of the pair open
+  return key.first == key.second && same(first, b) && same(second, a);
+}
+
+/*!
+ * @brief Returns the compatibility distance between two genomes.
+ *
+ * @details The pair is ordered by hash before lookup and computation, so both
+ * directions share one entry and get the same result. A slot found by the
+ * hashes is only used if it holds the same genomes; otherwise, after a hash
+ * collision or once its genomes are gone, it is refilled. The distance is
+ * computed outside the shard lock.
+ *
+ * @param a The first Genome.
+ * @param hash_a a->GetHash().
+ * @param b The second Genome.
+ * @param hash_b b->GetHash().
+ *
+ * @return The value of CompatibilityBetweenGenomes for the pair.
+ */
+double CompatibilityCache::Distance(const std::shared_ptr<const Genome> &a,
+                                    std::size_t hash_a,
+                                    const std::shared_ptr<const Genome> &b,
+                                    std::size_t hash_b) {
+  const std::shared_ptr<const Genome> *first = &a;
+  const std::shared_ptr<const Genome> *second = &b;
+  if (hash_b < hash_a) {
+    std::swap(first, second);
+    std::swap(hash_a, hash_b);
+  }
+
+  std::size_t capacity =
+      std::max(0, SETTINGS.compatibility.compatibility_cache_size) / kShards;
+  if (capacity == 0) {
+    misses_++;
+    return (*first)->CompatibilityBetweenGenomes(**second);
+  }
+
+  Key key{hash_a, hash_b};
+  std::size_t key_hash = KeyHash()(key);
+  Shard &shard = ShardOf(key_hash);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      Slot &slot = shard.slots[it->second];
+      if (slot.Holds(**first, **second)) {
+        hits_++;
+        slot.referenced = true;
+        return slot.distance;
+      }
+    }
+  }
+
+  misses_++;
+  double distance = (*first)->CompatibilityBetweenGenomes(**second);
+  Slot slot{key, *first, *second, distance};
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    Insert(shard, std::move(slot), capacity);
+  } else if (!shard.slots[it->second].Holds(**first, **second)) {
+    shard.slots[it->second] = std::move(slot);
+  }
+  return distance;
+}
+
+CompatibilityCache::Shard &CompatibilityCache::ShardOf(std::size_t key_hash) {
+  return shards_[(key_hash >> 32) % kShards];
+}
+
+/*!
+ * @brief Stores a distance, evicting with the clock policy when the shard is
+ * full. The caller holds the shard lock.
+ */
+void CompatibilityCache::Insert(Shard &shard, Slot slot,
+                                std::size_t capacity) {
+  const Key key = slot.key;
+  if (shard.slots.size() < capacity) {
+    shard.index.emplace(key, static_cast<int>(shard.slots.size()));
+    shard.slots.push_back(std::move(slot));
+    return;
+  }
+  // second chance: referenced slots are spared once
+  int size = shard.slots.size();
+  while (shard.slots[shard.hand].referenced) {
+    shard.slots[shard.hand].referenced = false;
+    shard.hand = (shard.hand + 1) % size;
+  }
+  Slot &victim = shard.slots[shard.hand];
+  shard.index.erase(victim.key);
+  victim = std::move(slot);
+  shard.index.emplace(key, shard.hand);
+  shard.hand = (shard.hand + 1) % size;
+}
+
+/*!
+ * @brief Drops every entry and resets the statistics. Needed if the
+ * compatibility weights of the settings change.
+ */
+void CompatibilityCache::Clear() {
+  for (Shard &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.slots.clear();
+    shard.hand = 0;
+  }
+  hits_ = 0;
+  misses_ = 0;
+}
+
+/*!
+ * @brief Returns the number of memoised distances.
+ */
+int CompatibilityCache::GetSize() {
+  int size = 0;
+  for (Shard &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.slots.size();
+  }
+  return size;
+}
+
+long CompatibilityCache::GetHits() const { return hits_; }
+
+long CompatibilityCache::GetMisses() const { return misses_; }
+
+/*!
+ * @brief Returns the share of lookups served from the cache, 0 before the
+ * first lookup.
+ */
+double CompatibilityCache::GetHitRate() const {
+  long hits = hits_;
+  long total = hits + misses_;
+  return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+}
+
+}  // end of namespace neat
@@ -7,6 +7,7 @@
  */
 
 #include <algorithm>
+#include <functional>
 #include <optional>
 #include "core/random.h"
 #include "core/settings.h"
@@ -36,24 +37,14 @@ Genome::Genome(int input_count, int output_count) : neurons_(), links_() {
  *
  * @return The count of input neurons.
  */
-int Genome::GetInputCount() const {
-  return std::count_if(neurons_.begin(), neurons_.end(),
-                       [](const Neuron& neuron) {
-                         return neuron.GetType() == NeuronType::kInput;
-                       });
-}
+int Genome::GetInputCount() const { return input_ids_.size(); }
 
 /*!
  * @brief Gets the number of output neurons in the Genome.
  *
  * @return The count of output neurons.
  */
-int Genome::GetOutputCount() const {
-  return std::count_if(neurons_.begin(), neurons_.end(),
-                       [](const Neuron& neuron) {
-                         return neuron.GetType() == NeuronType::kOutput;
-                       });
-}
+int Genome::GetOutputCount() const { return output_ids_.size(); }
 
 /*!
  * @brief Gets the list of neurons in the Genome.
@@ -75,7 +66,24 @@ const std::vector<Link>& Genome::GetLinks() const { return links_; }
  * @return A vector of BrainModule objects representing the modules currently in
  * the genome.
  */
-std::vector<BrainModule> Genome::GetModules() const { return modules_; }
+const std::vector<BrainModule>& Genome::GetModules() const { return modules_; }
+
+/*!
+ * @brief The modules a new genome can evolve.
+ *
+ * @details Module ids: 1 geolocation, 2 pheromone, 3 vision (one more entity
+ * in sight), 4 ray-cast vision with 3 inputs per ray, offered when
+ * SETTINGS.environment.vision_rays is positive.
+ */
+std::vector<BrainModule> Genome::DefaultModules() {
+  std::vector<BrainModule> modules = {BrainModule(3, 0, 1),
+                                      BrainModule(1, 1, 2, true),
+                                      BrainModule(5, 0, 3, true)};
+  if (SETTINGS.environment.vision_rays > 0) {
+    modules.emplace_back(3 * SETTINGS.environment.vision_rays, 0, 4);
+  }
+  return modules;
+}
 
 /*!
  * @brief Retrieves the list of available modules.
@@ -92,18 +100,198 @@ std::vector<BrainModule> Genome::GetAvailableModules() const {
  *
  * @param neuron The Neuron to be added.
  */
-void Genome::AddNeuron(const Neuron& neuron) { neurons_.push_back(neuron); }
+void Genome::AddNeuron(const Neuron& neuron) {
+  IdsOfType(neuron.GetType()).push_back(neuron.GetId());
+  Adjacency adjacency;
+  adjacency.order = next_order_++;
+  if (neurons_.empty() || neurons_.back().GetId() <= neuron.GetId()) {
+    neurons_.push_back(neuron);  // new neurons have the largest id
+    adjacency_.push_back(std::move(adjacency));
+    return;
+  }
+  auto position = std::upper_bound(
+      neurons_.begin(), neurons_.end(), neuron.GetId(),
+      [](std::int64_t id, const Neuron& other) { return id < other.GetId(); });
+  adjacency_.insert(adjacency_.begin() + (position - neurons_.begin()),
+                    std::move(adjacency));
+  neurons_.insert(position, neuron);
+}
 
 /*!
  * @brief Adds a link (connection) between neurons in the Genome.
  *
  * @param link The Link to be added.
  */
-void Genome::AddLink(const Link& link) { links_.push_back(link); }
+void Genome::AddLink(const Link& link) {
+  IndexLink(link);
+  if (links_.empty() || links_.back().GetId() <= link.GetId()) {
+    links_.push_back(link);  // new links have the largest id
+    return;
+  }
+  auto position = std::upper_bound(
+      links_.begin(), links_.end(), link.GetId(),
+      [](std::int64_t id, const Link& other) { return id < other.GetId(); });
+  links_.insert(position, link);
+}
+
+/*!
+ * @brief Finds the position of a neuron by binary search on its id.
+ *
+ * @return The index in neurons_, or -1 if there is no such neuron.
+ */
+int Genome::NeuronIndex(std::int64_t id) const {
+  auto it = std::lower_bound(
+      neurons_.begin(), neurons_.end(), id,
+      [](const Neuron& neuron, std::int64_t id) { return neuron.GetId() < id; });
+  if (it == neurons_.end() || it->GetId() != id) return -1;
+  return it - neurons_.begin();
+}
+
+/*!
+ * @brief Finds the position of a link by binary search on its id.
+ *
+ * @return The index in links_, or -1 if there is no such link.
+ */
+int Genome::LinkIndex(std::int64_t id) const {
+  auto it = std::lower_bound(
+      links_.begin(), links_.end(), id,
+      [](const Link& link, std::int64_t id) { return link.GetId() < id; });
+  if (it == links_.end() || it->GetId() != id) return -1;
+  return it - links_.begin();
+}
+
+/*!
+ * @brief Returns the list of neuron ids of a type.
+ */
+std::vector<std::int64_t>& Genome::IdsOfType(NeuronType type) {
+  if (type == NeuronType::kInput) return input_ids_;
+  if (type == NeuronType::kOutput) return output_ids_;
+  return hidden_ids_;
+}
+
+/*!
+ * @brief Searches the non-cyclic links forward from a neuron, visiting only
+ * neurons ranked at most max_order.
+ *
+ * @param from_index Index of the neuron to start from.
+ * @param to_index Index of the neuron to look for.
+ * @param max_order Largest rank visited.
+ * @param reached If not null, receives the indices of the visited neurons.
+ *
+ * @return True if to_index was reached.
+ */
+bool Genome::Reaches(int from_index, int to_index, int max_order,
+                     std::vector<int>* reached) const {
+  std::unordered_set<int> visited = {from_index};
+  std::vector<int> stack = {from_index};
+  while (!stack.empty()) {
+    int index = stack.back();
+    stack.pop_back();
+    if (index == to_index) return true;
+    if (reached) reached->push_back(index);
+    for (std::int64_t successor_id : adjacency_[index].successors) {
+      int successor = NeuronIndex(successor_id);
+      if (successor == -1 || adjacency_[successor].order > max_order) continue;
+      if (visited.insert(successor).second) stack.push_back(successor);
+    }
+  }
+  return false;
+}
+
+/*!
+ * @brief Repairs the topological order for a new non-cyclic link.
+ *
+ * @details Incremental ordering of Pearce and Kelly: if the link goes against
+ * the current order, only the neurons ranked between its two ends are
+ * searched and the ranks of those which must move are permuted among
+ * themselves.
+ *
+ * @param in_index Index of the source neuron.
+ * @param out_index Index of the target neuron.
+ *
+ * @return False, leaving the order untouched, if the link closes a cycle.
+ */
+bool Genome::InsertInOrder(int in_index, int out_index) {
+  int upper = adjacency_[in_index].order;
+  int lower = adjacency_[out_index].order;
+  if (upper < lower) return true;
+
+  std::vector<int> forward;
+  if (Reaches(out_index, in_index, upper, &forward)) return false;
+
+  std::vector<int> backward;
+  std::unordered_set<int> visited = {in_index};
+  std::vector<int> stack = {in_index};
+  while (!stack.empty()) {
+    int index = stack.back();
+    stack.pop_back();
+    backward.push_back(index);
+    for (std::int64_t predecessor_id : adjacency_[index].predecessors) {
+      int predecessor = NeuronIndex(predecessor_id);
+      if (predecessor == -1 || adjacency_[predecessor].order < lower) continue;
+      if (visited.insert(predecessor).second) stack.push_back(predecessor);
+    }
+  }
+
+  // the ancestors of in_index now precede the descendants of out_index,
+  // each group keeping its own relative order
+  auto by_order = [this](int a, int b) {
+    return adjacency_[a].order < adjacency_[b].order;
+  };
+  std::sort(backward.begin(), backward.end(), by_order);
+  std::sort(forward.begin(), forward.end(), by_order);
+  std::vector<int> moved = backward;
+  moved.insert(moved.end(), forward.begin(), forward.end());
+  std::vector<int> ranks;
+  for (int index : moved) ranks.push_back(adjacency_[index].order);
+  std::sort(ranks.begin(), ranks.end());
+  for (int i = 0; i < moved.size(); i++) adjacency_[moved[i]].order = ranks[i];
+  return true;
+}
+
+/*!
+ * @brief Records a link in the adjacency of its neurons.
+ *
+ * @details A non-cyclic link which would close a cycle is recorded as cyclic,
+ * which keeps the order valid; mutations never produce such links.
+ */
+void Genome::IndexLink(const Link& link) {
+  int in_index = NeuronIndex(link.GetInId());
+  int out_index = NeuronIndex(link.GetOutId());
+  if (in_index == -1 || out_index == -1) return;
+  if (link.IsCyclic() || !InsertInOrder(in_index, out_index)) {
+    adjacency_[in_index].cyclic_successors.push_back(link.GetOutId());
+    return;
+  }
+  adjacency_[in_index].successors.push_back(link.GetOutId());
+  adjacency_[out_index].predecessors.push_back(link.GetInId());
+}
+
+/*!
+ * @brief Removes a link from the adjacency of its neurons. Removing a link
+ * never invalidates the topological order.
+ */
+void Genome::UnindexLink(const Link& link) {
+  int in_index = NeuronIndex(link.GetInId());
+  int out_index = NeuronIndex(link.GetOutId());
+  if (in_index == -1 || out_index == -1) return;
+  auto erase_one = [](std::vector<std::int64_t>& ids, std::int64_t id) {
+    auto it = std::find(ids.begin(), ids.end(), id);
+    if (it == ids.end()) return false;
+    ids.erase(it);
+    return true;
+  };
+  Adjacency& in = adjacency_[in_index];
+  if (!link.IsCyclic() && erase_one(in.successors, link.GetOutId())) {
+    erase_one(adjacency_[out_index].predecessors, link.GetInId());
+    return;
+  }
+  erase_one(in.cyclic_successors, link.GetOutId());
+}
 
 // The function should not be used for now
 /*
-void Genome::DisableNeuron(int id) {
+void Genome::DisableNeuron(std::int64_t id) {
   for (Neuron& neuron: neurons_) {
     if (neuron.GetId()==id){
         neuron.SetInactive();
@@ -132,17 +320,14 @@ void Genome::SetAvailableModules(const std::vector<BrainModule>& modules) {
  *
  * @param id The unique identifier of the link to disable.
  */
-void Genome::DisableLink(int id) {
-  for (Link& link : links_) {
-    if (link.GetId() == id) {
-      link.SetInactive();
-    }
-  }
+void Genome::DisableLink(std::int64_t id) {
+  int index = LinkIndex(id);
+  if (index != -1) links_[index].SetInactive();
 }
 
 // The function should not be used for now
 /*
-void Genome::EnableNeuron(int id) {
+void Genome::EnableNeuron(std::int64_t id) {
   for (Neuron& neuron: neurons_) {
     if (neuron.GetId()==id){
         neuron.SetActive();
@@ -165,12 +350,9 @@ neuron.GetId()==link.GetOutId()){
  *
  * @param id The unique identifier of the link to enable.
  */
-void Genome::EnableLink(int id) {
-  for (Link& link : links_) {
-    if (link.GetId() == id) {
-      link.SetActive();
-    }
-  }
+void Genome::EnableLink(std::int64_t id) {
+  int index = LinkIndex(id);
+  if (index != -1) links_[index].SetActive();
 }
 
 /*!
@@ -178,28 +360,22 @@ void Genome::EnableLink(int id) {
  *
  * @param id The unique identifier of the neuron to remove.
  */
-void Genome::RemoveNeuron(int id) {
-  int index_to_delete = -1;
-  for (int i = 0; i < neurons_.size(); ++i) {
-    if (neurons_[i].GetId() == id) {
-      index_to_delete = i;
-      break;
-    }
-  }
+void Genome::RemoveNeuron(std::int64_t id) {
+  int index_to_delete = NeuronIndex(id);
 
   if (index_to_delete != -1) {
-    std::vector<int> links_to_remove;
-    for (int i = links_.size() - 1; i >= 0; i--) {
-      if (neurons_[index_to_delete].GetId() == links_[i].GetInId() ||
-          neurons_[index_to_delete].GetId() == links_[i].GetOutId()) {
-        links_to_remove.push_back(i);
-      }
-    }
-
-    for (int i : links_to_remove) {
-      links_.erase(links_.begin() + i);
+    auto touches = [id](const Link& link) {
+      return link.GetInId() == id || link.GetOutId() == id;
+    };
+    for (const Link& link : links_) {
+      if (touches(link)) UnindexLink(link);
     }
+    links_.erase(std::remove_if(links_.begin(), links_.end(), touches),
+                 links_.end());
 
+    std::vector<std::int64_t>& ids = IdsOfType(neurons_[index_to_delete].GetType());
+    ids.erase(std::find(ids.begin(), ids.end(), id));
+    adjacency_.erase(adjacency_.begin() + index_to_delete);
     neurons_.erase(neurons_.begin() + index_to_delete);
   }
 }
@@ -254,6 +430,20 @@ void Genome::Mutate() {
   }
 }
 
+/*!
+ * @brief Upper bound on the neurons one Mutate adds: a hidden neuron and the
+ * largest brain module still available. Callers reserving ids for mutations
+ * size their ranges with it, see IdService::ReserveBatch.
+ */
+int Genome::MaxNeuronsPerMutation() const {
+  int largest = 0;
+  for (const BrainModule& module : AvailableModules) {
+    largest = std::max<int>(largest, module.GetInputNeuronIds().size() +
+                                         module.GetOutputNeuronIds().size());
+  }
+  return 1 + largest;
+}
+
 /*!
  * @brief Mutates the Genome by removing a neuron.
  *
@@ -261,14 +451,8 @@ void Genome::Mutate() {
  * its associated links.
  */
 void Genome::MutateRemoveNeuron() {
-  std::vector<int> hiddenIDs = {};
-  for (const Neuron& neuron : GetNeurons()) {
-    if (neuron.GetType() == NeuronType::kHidden) {
-      hiddenIDs.push_back(neuron.GetId());
-    }
-  }
-  if (!hiddenIDs.empty()) {
-    RemoveNeuron(hiddenIDs[Random::Int(0, hiddenIDs.size() - 1)]);
+  if (!hidden_ids_.empty()) {
+    RemoveNeuron(hidden_ids_[Random::Int(0, hidden_ids_.size() - 1)]);
   }
 }
 
@@ -279,7 +463,7 @@ void Genome::MutateRemoveNeuron() {
  */
 void Genome::MutateRemoveLink() {
   if (!links_.empty()) { 
-    int idToRemove = links_[Random::Int(0, links_.size()-1)].GetId();
+    std::int64_t idToRemove = links_[Random::Int(0, links_.size()-1)].GetId();
     RemoveLink(idToRemove);
   }
 }
@@ -292,14 +476,39 @@ void Genome::MutateRemoveLink() {
  *
  * @return True if the link exists, false otherwise.
  */
-bool Genome::HasLink(const int& inID, const int& outID) {
-  for (const auto& link : links_) {
-    if (link.GetInId() == inID && link.GetOutId() == outID ||
-        link.GetInId() == outID && link.GetOutId() == inID) {
-      return true;
-    }
-  }
-  return false;
+bool Genome::HasLink(std::int64_t inID, std::int64_t outID) {
+  auto linked = [this](std::int64_t from, std::int64_t to) {
+    int index = NeuronIndex(from);
+    if (index == -1) return false;
+    const Adjacency& adjacency = adjacency_[index];
+    return std::find(adjacency.successors.begin(), adjacency.successors.end(),
+                     to) != adjacency.successors.end() ||
+           std::find(adjacency.cyclic_successors.begin(),
+                     adjacency.cyclic_successors.end(),
+                     to) != adjacency.cyclic_successors.end();
+  };
+  return linked(inID, outID) || linked(outID, inID);
+}
+
+/*!
+ * @brief Checks whether a non-cyclic link from in_id to out_id would close a
+ * cycle.
+ *
+ * @details Only neurons ranked between the two ends in the topological order
+ * are searched, and none at all if the link follows the order.
+ *
+ * @param in_id The id of the source neuron.
+ * @param out_id The id of the target neuron.
+ *
+ * @return True if out_id already reaches in_id through non-cyclic links.
+ */
+bool Genome::CreatesCycle(std::int64_t in_id, std::int64_t out_id) const {
+  int in_index = NeuronIndex(in_id);
+  int out_index = NeuronIndex(out_id);
+  if (in_index == -1 || out_index == -1) return false;
+  int upper = adjacency_[in_index].order;
+  if (upper < adjacency_[out_index].order) return false;
+  return Reaches(out_index, in_index, upper, nullptr);
 }
 
 /*!
@@ -307,15 +516,10 @@ bool Genome::HasLink(const int& inID, const int& outID) {
  *
  * @param id The unique identifier of the link to remove.
  */
-void Genome::RemoveLink(int id) {
-  int index_to_delete = -1;
-  for (int i = 0; i < links_.size(); i++) {
-    if (links_[i].GetId() == id) {
-      index_to_delete = i;
-      break;
-    }
-  }
+void Genome::RemoveLink(std::int64_t id) {
+  int index_to_delete = LinkIndex(id);
   if (index_to_delete != -1) {
+    UnindexLink(links_[index_to_delete]);
     links_.erase(links_.begin() + index_to_delete);
   }
 }
@@ -385,9 +589,9 @@ void Genome::MutateChangeBias() {
  *
  * @return True if a cycle is detected, false otherwise.
  */
-bool Genome::DFS(const Neuron& currentNeuron, std::unordered_set<int>& visited,
-                 std::unordered_set<int>& visiting) const {
-  int currentId = currentNeuron.GetId();
+bool Genome::DFS(const Neuron& currentNeuron, std::unordered_set<std::int64_t>& visited,
+                 std::unordered_set<std::int64_t>& visiting) const {
+  std::int64_t currentId = currentNeuron.GetId();
 
   if (visiting.find(currentId) != visiting.end()) {
     return true;  // loop
@@ -399,20 +603,13 @@ bool Genome::DFS(const Neuron& currentNeuron, std::unordered_set<int>& visited,
 
   visiting.insert(currentId);
 
-  for (const auto& link : links_) {
-    if (link.IsCyclic()) {
-      continue;
-    }
-    // link is not cyclic
-    if (link.GetInId() == currentId) {
-      int neighborId = link.GetOutId();
-      auto neighborIt = std::find_if(
-          neurons_.begin(), neurons_.end(),
-          [neighborId](const Neuron& n) {  // find the neuron w right id
-            return n.GetId() == neighborId;
-          });
-
-      if (neighborIt != neurons_.end() && DFS(*neighborIt, visited, visiting)) {
+  int index = NeuronIndex(currentId);
+  if (index != -1) {
+    // successors only hold the non-cyclic links
+    for (std::int64_t neighborId : adjacency_[index].successors) {
+      int neighborIndex = NeuronIndex(neighborId);
+      if (neighborIndex != -1 &&
+          DFS(neurons_[neighborIndex], visited, visiting)) {
         return true;  // found loop
       }
     }
@@ -432,8 +629,8 @@ bool Genome::DFS(const Neuron& currentNeuron, std::unordered_set<int>& visited,
  * @return True if a cycle is detected, false otherwise.
  */
 bool Genome::DetectLoops(const Neuron& startNeuron) {
-  std::unordered_set<int> visited;
-  std::unordered_set<int> visiting;
+  std::unordered_set<std::int64_t> visited;
+  std::unordered_set<std::int64_t> visiting;
 
   return DFS(startNeuron, visited, visiting);
 }
@@ -441,33 +638,36 @@ bool Genome::DetectLoops(const Neuron& startNeuron) {
 /*!
  * @brief Mutates the Genome by adding a new link between neurons.
  *
- * @details Adds a new link between two randomly chosen neurons.
+ * @details Adds a new link from a random non-output neuron to a random
+ * non-input neuron, both drawn directly from the per-type lists.
  * If this creates a cycle, the added link is characterized as cyclic
  * and its parameter cyclic_ is set to true.
  */
 void Genome::MutateAddLink() {
-  size_t indexRandomNeuron1 = Random::Int(0, neurons_.size() - 1);
-  size_t indexRandomNeuron2 = Random::Int(0, neurons_.size() - 1);
-  while (neurons_[indexRandomNeuron1].GetType() == NeuronType::kOutput) {
-    indexRandomNeuron1 = Random::Int(0, neurons_.size() - 1);
-  }
-  while (neurons_[indexRandomNeuron2].GetType() == NeuronType::kInput) {
-    indexRandomNeuron2 = Random::Int(0, neurons_.size() - 1);
-  }
-
-  int n1 = neurons_[indexRandomNeuron1].GetId();  // id of in neuron
-  int n2 = neurons_[indexRandomNeuron2].GetId();  // id of out neuron
+  int sources = input_ids_.size() + hidden_ids_.size();
+  int targets = hidden_ids_.size() + output_ids_.size();
+  if (sources == 0 || targets == 0) return;
+  int source = Random::Int(0, sources - 1);
+  int target = Random::Int(0, targets - 1);
+
+  // id of in neuron
+  std::int64_t n1 = source < input_ids_.size() ? input_ids_[source]
+                                      : hidden_ids_[source - input_ids_.size()];
+  // id of out neuron
+  std::int64_t n2 = target < hidden_ids_.size()
+               ? hidden_ids_[target]
+               : output_ids_[target - hidden_ids_.size()];
 
   if (HasLink(n1, n2)) {
     return;  // IF WE END UP USING ENABLED/DISABLE LINKS, THEN ENABLE LINK
   }
 
   // Check if cycle exists:
-  AddLink(Link(n1, n2, 1));
-  if (DetectLoops(neurons_[indexRandomNeuron1])) {
-    links_.back().SetCyclic();
-    return;
+  Link link(n1, n2, 1);
+  if (CreatesCycle(n1, n2)) {
+    link.SetCyclic();
   }
+  AddLink(link);
 }
 
 /*!
@@ -484,9 +684,10 @@ void Genome::MutateAddNeuron() {
   Link RandomLink = links_[randIndex];
   DisableLink(RandomLink.GetId());  // test
 
-  AddNeuron(Neuron(NeuronType::kHidden, 0.0));
+  Neuron newNeuron(NeuronType::kHidden, 0.0);
+  AddNeuron(newNeuron);
   // disable the initial link between the inId and outId
-  int newNeuronId = neurons_.back().GetId();
+  std::int64_t newNeuronId = newNeuron.GetId();
   Link newlink1(RandomLink.GetInId(), newNeuronId, 1);
   Link newlink2(newNeuronId, RandomLink.GetOutId(), RandomLink.GetWeight());
   if (RandomLink.IsCyclic()) {
@@ -508,50 +709,43 @@ Genome Crossover(const Genome& dominant, const Genome& recessive) {
   // Initialize the offspring Genome with no inputs and outputs initially.
   Genome offspring{0, 0};
 
-  // Iterate over the neurons in the dominant Genome.
+  // Both genomes are sorted by id, so corresponding neurons and links are
+  // found with a single merge pass over each pair of vectors.
+  const std::vector<Neuron>& recessive_neurons = recessive.GetNeurons();
+  auto recessive_neuron = recessive_neurons.begin();
   for (const auto& dominant_neuron : dominant.GetNeurons()) {
-    int neuron_id = dominant_neuron.GetId();
-    std::optional<Neuron> recessive_neuron;
-
-    // Search for the corresponding neuron in the recessive Genome.
-    for (const auto& recessive_neuron_candidate : recessive.GetNeurons()) {
-      if (recessive_neuron_candidate.GetId() == neuron_id) {
-        recessive_neuron = recessive_neuron_candidate;
-        break;
-      }
+    std::int64_t neuron_id = dominant_neuron.GetId();
+    while (recessive_neuron != recessive_neurons.end() &&
+           recessive_neuron->GetId() < neuron_id) {
+      ++recessive_neuron;
     }
 
     // If the neuron is not found in the recessive Genome, add it to the
     // offspring.
-    if (!recessive_neuron) {
+    if (recessive_neuron == recessive_neurons.end() ||
+        recessive_neuron->GetId() != neuron_id) {
       offspring.AddNeuron(dominant_neuron);
     } else {
       // If the neuron is found, combine the properties from both parents.
-      offspring.AddNeuron(
-          CrossoverNeuron(dominant_neuron, recessive_neuron.value()));
+      offspring.AddNeuron(CrossoverNeuron(dominant_neuron, *recessive_neuron));
     }
   }
 
-  // Similar process for links - iterate over links in the dominant Genome.
+  // Similar process for links.
+  const std::vector<Link>& recessive_links = recessive.GetLinks();
+  auto recessive_link = recessive_links.begin();
   for (const auto& dominant_link : dominant.GetLinks()) {
-    int link_id = dominant_link.GetId();
-    std::optional<Link> recessive_link;
-
-    // Search for the corresponding link in the recessive Genome.
-    for (const auto& recessive_link_candidate : recessive.GetLinks()) {
-      if (recessive_link_candidate.GetId() == link_id) {
-        recessive_link = recessive_link_candidate;
-        break;
-      }
+    std::int64_t link_id = dominant_link.GetId();
+    while (recessive_link != recessive_links.end() &&
+           recessive_link->GetId() < link_id) {
+      ++recessive_link;
     }
 
-    // If the link is not found in the recessive Genome, add it to the
-    // offspring.
-    if (!recessive_link) {
+    if (recessive_link == recessive_links.end() ||
+        recessive_link->GetId() != link_id) {
       offspring.AddLink(dominant_link);
     } else {
-      // If the link is found, combine the properties from both parents.
-      offspring.AddLink(CrossoverLink(dominant_link, recessive_link.value()));
+      offspring.AddLink(CrossoverLink(dominant_link, *recessive_link));
     }
   }
   std::vector<BrainModule> modules_dominant = dominant.GetModules();
@@ -573,13 +767,11 @@ Genome Crossover(const Genome& dominant, const Genome& recessive) {
  * randomly chosen from a predefined list of activation types.
  */
 void Genome::MutateActivationFunction() {
-    if (GetInputCount()+GetOutputCount()==neurons_.size()){
+    if (hidden_ids_.empty()){
         return ;
     }
-    size_t indexRandomNeuronHidden = Random::Int(0, neurons_.size() - 1);
-    while (neurons_[indexRandomNeuronHidden].GetType() != NeuronType::kHidden) {
-      indexRandomNeuronHidden = Random::Int(0, neurons_.size() - 1);
-    }
+    int indexRandomNeuronHidden =
+        NeuronIndex(hidden_ids_[Random::Int(0, hidden_ids_.size() - 1)]);
     std::vector<ActivationType> activationTypes = {
             ActivationType::sigmoid,
             ActivationType::relu,
@@ -609,20 +801,22 @@ void Genome::MutateActivateBrainModule(){
    })) return;
 
   int input_size = module.GetInputNeuronIds().size();
-  std::vector<int> input_ids(input_size, 0);
+  std::vector<std::int64_t> input_ids(input_size, 0);
   for (int i = 0; i < module.GetInputNeuronIds().size(); i++){
     if (i == 0) module.SetFirstInputIndex(GetInputCount());
-    AddNeuron(Neuron(NeuronType::kInput, 0));
-    input_ids.at(i) = neurons_.back().GetId();
+    Neuron input(NeuronType::kInput, 0);
+    AddNeuron(input);
+    input_ids.at(i) = input.GetId();
   }
   module.SetInputNeuronIds(input_ids);
 
   int output_size = module.GetOutputNeuronIds().size();
-  std::vector<int> output_ids(output_size, 0);
+  std::vector<std::int64_t> output_ids(output_size, 0);
   for (int i = 0; i < module.GetOutputNeuronIds().size(); i++){
     if (i == 0) module.SetFirstOutputIndex(GetOutputCount());
-    AddNeuron(Neuron(NeuronType::kOutput, 0));
-    output_ids.at(i) = neurons_.back().GetId();
+    Neuron output(NeuronType::kOutput, 0);
+    AddNeuron(output);
+    output_ids.at(i) = output.GetId();
   }
   module.SetOutputNeuronIds(output_ids);
   modules_.push_back(module);
@@ -642,10 +836,10 @@ void Genome::MutateDisableBrainModule(){
   int randomIndex = Random::Int(0, modules_.size() -1);
   BrainModule module = modules_.at(randomIndex);
   modules_.erase(modules_.begin() + randomIndex);
-  for (const int i : module.GetInputNeuronIds()){
+  for (const std::int64_t i : module.GetInputNeuronIds()){
     RemoveNeuron(i);
   }
-  for (const int i : module.GetOutputNeuronIds()){
+  for (const std::int64_t i : module.GetOutputNeuronIds()){
     RemoveNeuron(i);
   }
 }
@@ -658,14 +852,11 @@ void Genome::MutateDisableBrainModule(){
  * be stored.
  * @return True if the neuron is found, false otherwise.
  */
-bool Genome::FindNeuronById(int targetId, Neuron& foundNeuron) const{
-    for (const Neuron& neuron : neurons_) {
-        if (neuron.GetId() == targetId) {
-            foundNeuron = neuron;  // Assign the found neuron to the reference parameter
-            return true;  // Return true if the neuron is found
-        }
-    }
-    return false;  // Return false if neuron isnt found
+bool Genome::FindNeuronById(std::int64_t targetId, Neuron& foundNeuron) const{
+    int index = NeuronIndex(targetId);
+    if (index == -1) return false;  // Return false if neuron isnt found
+    foundNeuron = neurons_[index];  // Assign the found neuron to the reference parameter
+    return true;  // Return true if the neuron is found
 }
 
 /*!
@@ -674,54 +865,67 @@ bool Genome::FindNeuronById(int targetId, Neuron& foundNeuron) const{
  *
  * This method computes a distance based on the disjoint/excess neurons and
  * links, and weight difference between the two genomes, following a formula
- * from the paper.
+ * from the paper. Runs in linear time as both genomes are sorted by id.
  *
  * @param other A reference to another Genome object to compare with.
  * @return The calculated compatibility distance.
  */
 double Genome::CompatibilityBetweenGenomes(const Genome& other) const {
     double average_weight_difference = 0;
+    // Both genomes are sorted by id: shared neurons and links are found with
+    // a single merge pass.
     // Count shared neurons and their differences in bias
-    // std::unordered_map<int, Neuron> shared_neurons;
     int Nshared_neurons = 0;  // number of neurons that appear in both genomes
-    for (const Neuron& neuron : neurons_) {
-      Neuron other_neuron(neuron.GetType(),
-                          0);  // corresponding neuron of the other genome, if
-                               // it exists
-      if (other.FindNeuronById(neuron.GetId(), other_neuron)) {
-        Nshared_neurons++;
-        // add a relative difference in biases (a number between 0 and 2)
-        if (std::max(fabs(neuron.GetBias()), fabs(other_neuron.GetBias())) == 0) {
-          average_weight_difference +=
-                  fabs(neuron.GetBias() - other_neuron.GetBias());
-        } else {
-          average_weight_difference +=
-                  fabs(neuron.GetBias() - other_neuron.GetBias()) /
-                  std::max(fabs(neuron.GetBias()), fabs(other_neuron.GetBias()));
-        }
+    for (int i = 0, j = 0; i < neurons_.size() && j < other.neurons_.size();) {
+      const Neuron& neuron = neurons_[i];
+      const Neuron& other_neuron = other.neurons_[j];
+      if (neuron.GetId() < other_neuron.GetId()) {
+        i++;
+        continue;
+      }
+      if (other_neuron.GetId() < neuron.GetId()) {
+        j++;
+        continue;
+      }
+      Nshared_neurons++;
+      // add a relative difference in biases (a number between 0 and 2)
+      if (std::max(fabs(neuron.GetBias()), fabs(other_neuron.GetBias())) == 0) {
+        average_weight_difference +=
+                fabs(neuron.GetBias() - other_neuron.GetBias());
+      } else {
+        average_weight_difference +=
+                fabs(neuron.GetBias() - other_neuron.GetBias()) /
+                std::max(fabs(neuron.GetBias()), fabs(other_neuron.GetBias()));
       }
+      i++;
+      j++;
     }
 
     // Count shared links and their weight differences
-    // std::set<std::pair<int, int>> shared_link_pairs;
-    // Genome& non_const_this = const_cast<Genome&>(*this);
     int Nshared_links = 0;
-    for (const Link& link : links_) {
-      for (const Link& other_link : other.GetLinks()) {
-        if (link.GetId() == other_link.GetId()) {
-          Nshared_links++;
-          // add a relative difference in weights (a number between 0 and 2)
-          if (std::max(fabs(link.GetWeight()), fabs(other_link.GetWeight())) == 0){
-            average_weight_difference +=
-                    fabs(link.GetWeight() - other_link.GetWeight());
-          } else {
-            average_weight_difference +=
-                    fabs(link.GetWeight() - other_link.GetWeight()) /
-                    std::max(fabs(link.GetWeight()), fabs(other_link.GetWeight()));
-          }
-          break;
-        }
+    for (int i = 0, j = 0; i < links_.size() && j < other.links_.size();) {
+      const Link& link = links_[i];
+      const Link& other_link = other.links_[j];
+      if (link.GetId() < other_link.GetId()) {
+        i++;
+        continue;
+      }
+      if (other_link.GetId() < link.GetId()) {
+        j++;
+        continue;
+      }
+      Nshared_links++;
+      // add a relative difference in weights (a number between 0 and 2)
+      if (std::max(fabs(link.GetWeight()), fabs(other_link.GetWeight())) == 0){
+        average_weight_difference +=
+                fabs(link.GetWeight() - other_link.GetWeight());
+      } else {
+        average_weight_difference +=
+                fabs(link.GetWeight() - other_link.GetWeight()) /
+                std::max(fabs(link.GetWeight()), fabs(other_link.GetWeight()));
       }
+      i++;
+      j++;
     }
     if (Nshared_neurons + Nshared_links == 0){
         average_weight_difference = 0;
@@ -736,13 +940,17 @@ double Genome::CompatibilityBetweenGenomes(const Genome& other) const {
     int normalizing_factor_neurons =
         std::max(neurons_.size(), other.neurons_.size());
     double normalized_disjoint_neurons =
-        (double)Ndisjoint_neurons / (double)normalizing_factor_neurons;
+        normalizing_factor_neurons == 0
+            ? 0
+            : (double)Ndisjoint_neurons / (double)normalizing_factor_neurons;
 
     int Ndisjoint_links =
         links_.size() + other.links_.size() - 2 * Nshared_links;
     int normalizing_factor_links = std::max(links_.size(), other.links_.size());
     double normalized_disjoint_links =
-        (double)Ndisjoint_links / (double)normalizing_factor_links;
+        normalizing_factor_links == 0
+            ? 0
+            : (double)Ndisjoint_links / (double)normalizing_factor_links;
     // Compute compatibility distance based on disjoint/excess neurons and
     // links, and average weight difference.
     double compatibility_distance =
@@ -755,6 +963,91 @@ double Genome::CompatibilityBetweenGenomes(const Genome& other) const {
     return compatibility_distance;
 }
 
+namespace {
+
+void hash_combine(std::size_t& hash, std::size_t value) {
+  hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+}
+
+bool same_module(const BrainModule& a, const BrainModule& b) {
+  return a.GetModuleId() == b.GetModuleId() && a.GetType() == b.GetType() &&
+         a.GetMultiple() == b.GetMultiple() &&
+         a.GetFirstInputIndex() == b.GetFirstInputIndex() &&
+         a.GetFirstOutputIndex() == b.GetFirstOutputIndex() &&
+         a.GetInputNeuronIds() == b.GetInputNeuronIds() &&
+         a.GetOutputNeuronIds() == b.GetOutputNeuronIds();
+}
+
+}  // namespace
+
+/*!
+ * @brief Computes a hash of the content of the Genome.
+ *
+ * @details Covers every neuron, link and active module, in order. Two genomes
+ * comparing equal with operator== always have the same hash.
+ *
+ * @return The content hash.
+ */
+std::size_t Genome::GetHash() const {
+  std::size_t hash = std::hash<std::size_t>()(neurons_.size());
+  hash_combine(hash, links_.size());
+  for (const Neuron& neuron : neurons_) {
+    hash_combine(hash, neuron.GetId());
+    hash_combine(hash, static_cast<int>(neuron.GetType()));
+    hash_combine(hash, static_cast<int>(neuron.GetActivation()));
+    hash_combine(hash, std::hash<double>()(neuron.GetBias()));
+    hash_combine(hash, neuron.IsActive());
+  }
+  for (const Link& link : links_) {
+    hash_combine(hash, link.GetId());
+    hash_combine(hash, link.GetInId());
+    hash_combine(hash, link.GetOutId());
+    hash_combine(hash, std::hash<double>()(link.GetWeight()));
+    hash_combine(hash, link.IsActive());
+    hash_combine(hash, link.IsCyclic());
+  }
+  for (const BrainModule& module : modules_) {
+    hash_combine(hash, module.GetModuleId());
+    hash_combine(hash, module.GetType());
+    hash_combine(hash, module.GetFirstInputIndex());
+  }
+  return hash;
+}
+
+/*!
+ * @brief Checks whether two genomes have the same neurons, links and active
+ * modules, in the same order.
+ */
+bool Genome::operator==(const Genome& other) const {
+  if (neurons_.size() != other.neurons_.size() ||
+      links_.size() != other.links_.size() ||
+      modules_.size() != other.modules_.size()) {
+    return false;
+  }
+  for (int i = 0; i < neurons_.size(); i++) {
+    const Neuron& a = neurons_[i];
+    const Neuron& b = other.neurons_[i];
+    if (a.GetId() != b.GetId() || a.GetType() != b.GetType() ||
+        a.GetActivation() != b.GetActivation() ||
+        a.GetBias() != b.GetBias() || a.IsActive() != b.IsActive()) {
+      return false;
+    }
+  }
+  for (int i = 0; i < links_.size(); i++) {
+    const Link& a = links_[i];
+    const Link& b = other.links_[i];
+    if (a.GetId() != b.GetId() || a.GetInId() != b.GetInId() ||
+        a.GetOutId() != b.GetOutId() || a.GetWeight() != b.GetWeight() ||
+        a.IsActive() != b.IsActive() || a.IsCyclic() != b.IsCyclic()) {
+      return false;
+    }
+  }
+  for (int i = 0; i < modules_.size(); i++) {
+    if (!same_module(modules_[i], other.modules_[i])) return false;
+  }
+  return true;
+}
+
 
 
 // Genome minimallyViableGenome() {
@@ -5,13 +5,12 @@
  * @brief Defines the Link class and related functions for NEAT.
  */
 
+#include "core/id_service.h"
 #include "core/random.h"
 #include "stdexcept"
 
 namespace neat {
 
-int Link::next_id_ = 1;
-
 /*!
  * @brief Constructs a Link with specified input and output neuron IDs and
  * weight.
@@ -20,16 +19,16 @@ int Link::next_id_ = 1;
  * @param out_id The ID of the output neuron.
  * @param weight The weight of the connection.
  */
-Link::Link(int in_id, int out_id, double weight)
-    : id_(next_id_++),
+Link::Link(std::int64_t in_id, std::int64_t out_id, double weight)
+    : id_(IdService::Next(IdService::kLink)),
       in_id_(in_id),
       out_id_(out_id),
       weight_(weight),
       active_(true),
       cyclic_(false) {}
 
-Link::Link(int id, int in_id, int out_id, double weight, bool active,
-           bool cyclic)
+Link::Link(std::int64_t id, std::int64_t in_id, std::int64_t out_id,
+           double weight, bool active, bool cyclic)
     : id_(id),
       in_id_(in_id),
       out_id_(out_id),
@@ -43,21 +42,21 @@ Link::Link(int id, int in_id, int out_id, double weight, bool active,
  * @return The ID of the link.
  */
 
-int Link::GetId() const { return id_; }
+std::int64_t Link::GetId() const { return id_; }
 
 /*!
  * @brief Gets the ID of the input neuron.
  *
  * @return The input neuron ID.
  */
-int Link::GetInId() const { return in_id_; }
+std::int64_t Link::GetInId() const { return in_id_; }
 
 /*!
  * @brief Gets the ID of the output neuron.
  *
  * @return The output neuron ID.
  */
-int Link::GetOutId() const { return out_id_; }
+std::int64_t Link::GetOutId() const { return out_id_; }
 
 /*!
  * @brief Gets the weight of the link.
@@ -117,7 +116,7 @@ void Link::SetNonCyclic() { cyclic_ = false; }
  *
  * @return A new Link object.
  */
-Link NewLink(int in_id, int out_id, double weight);
+Link NewLink(std::int64_t in_id, std::int64_t out_id, double weight);
 
 /*!
  * @brief Performs crossover between two Links to produce a new Link.
@@ -0,0 +1,127 @@
+#include "neat/network_cache.h"
+/*!
+ * @file network_cache.cpp
+ *
+ * @brief Implements the cache of compiled networks shared between brains.
+ */
+
+#include <algorithm>
+
+namespace neat {
+
+/*!
+ * @brief Returns the compiled network of a genome, compiling it only if no
+ * living brain uses an identical genome.
+ *
+ * @details The returned pointer shares ownership of the cache entry, so the
+ * entry stays alive as long as any brain holds it. Compilation happens outside
+ * the lock; if another thread compiled the same genome meanwhile, its network
+ * is used instead.
+ *
+ * @param genom The Genome to compile.
+ *
+ * @return The shared compiled network.
+ */
+std::shared_ptr<const CompiledNetwork> NetworkCache::Get(const Genome &genom) {
+  return GetOrCompile(genom, nullptr);
+}
+
+/*!
+ * @brief Returns the compiled network of a shared genome.
+ *
+ * @details On a miss the entry references the shared genome instead of
+ * copying it.
+ *
+ * @param genom The shared Genome to compile.
+ *
+ * @return The shared compiled network.
+ */
+std::shared_ptr<const CompiledNetwork> NetworkCache::Get(
+    std::shared_ptr<const Genome> genom) {
+  const Genome &key = *genom;
+  return GetOrCompile(key, std::move(genom));
+}
+
+/*!
+ * @brief Looks up or compiles a network. shared is the genome kept as key on
+ * a miss, a copy of genom is made when it is null.
+ */
+std::shared_ptr<const CompiledNetwork> NetworkCache::GetOrCompile(
+    const Genome &genom, std::shared_ptr<const Genome> shared) {
+  std::size_t hash = genom.GetHash();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<const CompiledNetwork> network = Find(hash, genom);
+    if (network) {
+      hits_++;
+      return network;
+    }
+  }
+
+  if (!shared) shared = std::make_shared<const Genome>(genom);
+  auto entry = std::make_shared<Entry>(Entry{shared, CompileNetwork(genom)});
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::shared_ptr<const CompiledNetwork> network = Find(hash, genom);
+  if (network) {
+    hits_++;
+    return network;
+  }
+  misses_++;
+  if (entries_.size() >= sweep_at_) SweepExpired();
+  entries_.emplace(hash, std::weak_ptr<const Entry>(entry));
+  return std::shared_ptr<const CompiledNetwork>(entry, entry->network.get());
+}
+
+/*!
+ * @brief Looks up a live entry for a genome. The caller holds the lock.
+ */
+std::shared_ptr<const CompiledNetwork> NetworkCache::Find(
+    std::size_t hash, const Genome &genom) {
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second;) {
+    std::shared_ptr<const Entry> entry = it->second.lock();
+    if (!entry) {
+      it = entries_.erase(it);
+      continue;
+    }
+    if (*entry->genome == genom) {
+      return std::shared_ptr<const CompiledNetwork>(entry,
+                                                    entry->network.get());
+    }
+    ++it;
+  }
+  return nullptr;
+}
+
+/*!
+ * @brief Drops expired entries. The caller holds the lock.
+ *
+ * @details The next sweep is scheduled when the table has doubled, so the
+ * cost of sweeping stays amortised constant per insertion.
+ */
+void NetworkCache::SweepExpired() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.expired()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  sweep_at_ = std::max<std::size_t>(1024, 2 * entries_.size());
+}
+
+/*!
+ * @brief Returns the number of live compiled networks.
+ */
+int NetworkCache::GetSize() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  SweepExpired();
+  return entries_.size();
+}
+
+long NetworkCache::GetHits() const { return hits_; }
+
+long NetworkCache::GetMisses() const { return misses_; }
+
+}  // end of namespace neat
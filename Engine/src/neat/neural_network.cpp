@@ -8,173 +8,569 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <unordered_map>
 
+#include "neat/network_cache.h"
+
 namespace neat {
 
+namespace {
+
 /*!
- * @brief Constructs a NeuralNetwork from a given Genome.
+ * @brief Assigns every neuron of a genome to a layer.
  *
- * @param genome The Genome to construct the NeuralNetwork from.
+ * @details Active, non-cyclic links between inputs and hidden neurons are
+ * indexed once in CSR form and the hidden neurons are layered with Kahn's
+ * topological sort: inputs are layer 0, a hidden neuron sits one layer after
+ * its deepest source and outputs form the last layer. Hidden neurons caught in
+ * a cycle whose links are not marked as cyclic get a layer of their own after
+ * every other hidden neuron instead of stalling the sort. Runs in O(N + L).
+ *
+ * @param neurons The neurons of the genome.
+ * @param links The links of the genome.
+ * @param index_of Position in neurons of every neuron id.
+ * @param keep Neurons to layer; the others are ignored and get layer -1.
+ *
+ * @return The layer of every neuron, in the order of neurons.
  */
-NeuralNetwork::NeuralNetwork(const Genome &genom) {
-  std::vector<std::vector<Neuron> > layers = get_layers(genom);
-  // std::vector<Neuron> neurons = genom.GetNeurons();
-  std::vector<FeedForwardNeuron> ffneurons;
-  std::vector<int> input_ids;
-  for (const Neuron &neuron : layers.front()) {
-    input_ids.push_back(neuron.GetId());
-  }
-  input_ids_ = input_ids;
-  std::vector<int> output_ids;
-  for (const Neuron &neuron : layers.back()) {
-    output_ids.push_back(neuron.GetId());
-  }
-  output_ids_ = output_ids;
-  for (const std::vector<Neuron> &layer : layers) {
-    for (const Neuron &neuron : layer) {
-      std::vector<NeuronInput> inputs;
-      std::vector<NeuronInput> inputs_from_cycles;
-      for (const Link &link : genom.GetLinks()) {
-        if (link.GetOutId() == neuron.GetId()) {
-          NeuronInput input = {link.GetInId(), link.GetWeight()};
-          if (link.IsCyclic()) {
-            inputs_from_cycles.push_back(input);
-          } else {
-            inputs.push_back(input);
-          }
-        }
+std::vector<int> compute_layers(const std::vector<Neuron> &neurons,
+                                const std::vector<Link> &links,
+                                const std::unordered_map<std::int64_t, int> &index_of,
+                                const std::vector<char> &keep) {
+  int n = neurons.size();
+  std::vector<int> offsets(n + 1, 0);
+  std::vector<int> in_degree(n, 0);
+  std::vector<std::pair<int, int> > edges;
+  edges.reserve(links.size());
+  for (const Link &link : links) {
+    if (!link.IsActive() || link.IsCyclic()) continue;
+    auto in = index_of.find(link.GetInId());
+    auto out = index_of.find(link.GetOutId());
+    if (in == index_of.end() || out == index_of.end()) continue;
+    if (!keep[in->second] || !keep[out->second]) continue;
+    if (neurons[in->second].GetType() == NeuronType::kOutput ||
+        neurons[out->second].GetType() != NeuronType::kHidden) {
+      continue;
+    }
+    edges.push_back({in->second, out->second});
+    offsets[in->second + 1]++;
+    in_degree[out->second]++;
+  }
+  for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+  std::vector<int> targets(edges.size());
+  std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+  for (const std::pair<int, int> &edge : edges) {
+    targets[fill[edge.first]++] = edge.second;
+  }
+
+  std::vector<int> layer(n, -1);
+  std::vector<int> queue;
+  queue.reserve(n);
+  for (int i = 0; i < n; i++) {
+    if (!keep[i] || neurons[i].GetType() == NeuronType::kOutput) continue;
+    layer[i] = neurons[i].GetType() == NeuronType::kInput ? 0 : 1;
+    if (in_degree[i] == 0) queue.push_back(i);
+  }
+  int deepest = 0;
+  for (int head = 0; head < queue.size(); head++) {
+    int i = queue[head];
+    deepest = std::max(deepest, layer[i]);
+    for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+      int target = targets[k];
+      layer[target] = std::max(layer[target], layer[i] + 1);
+      if (--in_degree[target] == 0) queue.push_back(target);
+    }
+  }
+  if (queue.size() < n) {
+    bool stuck = false;
+    for (int i = 0; i < n; i++) {
+      if (keep[i] && neurons[i].GetType() == NeuronType::kHidden &&
+          in_degree[i] > 0) {
+        layer[i] = deepest + 1;
+        stuck = true;
       }
-      FeedForwardNeuron ffneuron = {
-          neuron.GetId(), neuron.GetBias(),   0.0,
-          inputs,         inputs_from_cycles, neuron.GetActivation()};
-      ffneurons.push_back(ffneuron);
     }
+    if (stuck) deepest++;
+  }
+  for (int i = 0; i < n; i++) {
+    if (keep[i] && neurons[i].GetType() == NeuronType::kOutput) {
+      layer[i] = deepest + 1;
+    }
+  }
+  return layer;
+}
+
+/*!
+ * @brief Marks the neurons which can influence an output.
+ *
+ * @details Walks the active links backwards from the outputs. Inputs and
+ * outputs are always kept, hidden neurons without a path to an output are
+ * dead ends.
+ */
+std::vector<char> reaches_output(const std::vector<Neuron> &neurons,
+                                 const std::vector<Link> &links,
+                                 const std::unordered_map<std::int64_t, int> &index_of) {
+  int n = neurons.size();
+  std::vector<int> offsets(n + 1, 0);
+  std::vector<std::pair<int, int> > edges;
+  edges.reserve(links.size());
+  for (const Link &link : links) {
+    if (!link.IsActive()) continue;
+    auto in = index_of.find(link.GetInId());
+    auto out = index_of.find(link.GetOutId());
+    if (in == index_of.end() || out == index_of.end()) continue;
+    edges.push_back({out->second, in->second});
+    offsets[out->second + 1]++;
+  }
+  for (int i = 0; i < n; i++) offsets[i + 1] += offsets[i];
+  std::vector<int> sources(edges.size());
+  std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+  for (const std::pair<int, int> &edge : edges) {
+    sources[fill[edge.first]++] = edge.second;
+  }
+
+  std::vector<char> keep(n, 0);
+  std::vector<int> stack;
+  for (int i = 0; i < n; i++) {
+    if (neurons[i].GetType() == NeuronType::kInput) keep[i] = 1;
+    if (neurons[i].GetType() == NeuronType::kOutput) {
+      keep[i] = 1;
+      stack.push_back(i);
+    }
+  }
+  while (!stack.empty()) {
+    int i = stack.back();
+    stack.pop_back();
+    for (int k = offsets[i]; k < offsets[i + 1]; k++) {
+      if (neurons[sources[k]].GetType() == NeuronType::kHidden &&
+          !keep[sources[k]]) {
+        keep[sources[k]] = 1;
+        stack.push_back(sources[k]);
+      }
+    }
+  }
+  return keep;
+}
+
+std::unordered_map<std::int64_t, int> index_neurons(const std::vector<Neuron> &neurons) {
+  std::unordered_map<std::int64_t, int> index_of;
+  index_of.reserve(neurons.size());
+  for (int i = 0; i < neurons.size(); i++) index_of[neurons[i].GetId()] = i;
+  return index_of;
+}
+
+}  // namespace
+
+/*!
+ * @brief Compiles a Genome into a topologically ordered flat-array network.
+ *
+ * @details Disabled links and hidden neurons without a path to an output are
+ * pruned. The remaining neurons are laid out layer by layer, with the neurons
+ * of a hidden layer sorted by activation so that each layer splits into as few
+ * ActivationGroups as possible. A non-cyclic link only feeds its target if its
+ * source lives in an earlier layer, which is exactly the set of links whose
+ * source has already been evaluated when the target is. Runs in O(N + L) apart
+ * from the per-layer sort.
+ *
+ * @param genom The Genome to compile.
+ *
+ * @return The immutable compiled network.
+ */
+std::shared_ptr<const CompiledNetwork> CompileNetwork(const Genome &genom) {
+  const std::vector<Neuron> &neurons = genom.GetNeurons();
+  const std::vector<Link> &links = genom.GetLinks();
+  std::unordered_map<std::int64_t, int> index_of = index_neurons(neurons);
+  std::vector<char> keep = reaches_output(neurons, links, index_of);
+  std::vector<int> layer = compute_layers(neurons, links, index_of, keep);
+
+  std::vector<int> order;  // neuron positions in evaluation order
+  order.reserve(neurons.size());
+  for (int i = 0; i < neurons.size(); i++) {
+    if (keep[i]) order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    if (layer[a] != layer[b]) return layer[a] < layer[b];
+    if (neurons[a].GetType() != NeuronType::kHidden) return false;
+    return neurons[a].GetActivation() < neurons[b].GetActivation();
+  });
+
+  auto compiled = std::make_shared<CompiledNetwork>();
+  int size = order.size();
+  std::vector<int> dense(neurons.size(), -1);
+  std::vector<int> layer_of(size);
+  compiled->ids.reserve(size);
+  compiled->bias.reserve(size);
+  compiled->activations.reserve(size);
+  for (int d = 0; d < size; d++) {
+    const Neuron &neuron = neurons[order[d]];
+    dense[order[d]] = d;
+    layer_of[d] = layer[order[d]];
+    compiled->ids.push_back(neuron.GetId());
+    compiled->bias.push_back(neuron.GetBias());
+    compiled->activations.push_back(neuron.GetActivation());
+    if (neuron.GetType() == NeuronType::kInput) compiled->input_count++;
+    if (neuron.GetType() == NeuronType::kOutput) compiled->output_count++;
+  }
+
+  // counting sort of the links by target keeps the genome order in every row
+  compiled->input_offsets.assign(size + 1, 0);
+  compiled->cycle_offsets.assign(size + 1, 0);
+  std::vector<std::pair<int, int> > kept_links;  // (link, source) pairs
+  std::vector<int> link_target;
+  kept_links.reserve(links.size());
+  for (int l = 0; l < links.size(); l++) {
+    const Link &link = links[l];
+    if (!link.IsActive()) continue;
+    auto in = index_of.find(link.GetInId());
+    auto out = index_of.find(link.GetOutId());
+    if (in == index_of.end() || out == index_of.end()) continue;
+    int source = dense[in->second];
+    int target = dense[out->second];
+    if (source < 0 || target < 0) continue;
+    if (link.IsCyclic()) {
+      compiled->cycle_offsets[target + 1]++;
+    } else if (layer_of[source] < layer_of[target]) {
+      compiled->input_offsets[target + 1]++;
+    } else {
+      continue;
+    }
+    kept_links.push_back({l, source});
+    link_target.push_back(target);
+  }
+  for (int i = 0; i < size; i++) {
+    compiled->input_offsets[i + 1] += compiled->input_offsets[i];
+    compiled->cycle_offsets[i + 1] += compiled->cycle_offsets[i];
+  }
+  compiled->input_sources.resize(compiled->input_offsets[size]);
+  compiled->input_weights.resize(compiled->input_offsets[size]);
+  compiled->cycle_sources.resize(compiled->cycle_offsets[size]);
+  compiled->cycle_weights.resize(compiled->cycle_offsets[size]);
+  std::vector<int> input_fill(compiled->input_offsets.begin(),
+                              compiled->input_offsets.end() - 1);
+  std::vector<int> cycle_fill(compiled->cycle_offsets.begin(),
+                              compiled->cycle_offsets.end() - 1);
+  for (int k = 0; k < kept_links.size(); k++) {
+    const Link &link = links[kept_links[k].first];
+    int target = link_target[k];
+    if (link.IsCyclic()) {
+      int slot = cycle_fill[target]++;
+      compiled->cycle_sources[slot] = kept_links[k].second;
+      compiled->cycle_weights[slot] = link.GetWeight();
+    } else {
+      int slot = input_fill[target]++;
+      compiled->input_sources[slot] = kept_links[k].second;
+      compiled->input_weights[slot] = link.GetWeight();
+    }
+  }
+
+  // hidden neurons are grouped by activation within their layer, outputs are
+  // left linear
+  int first_output = size - compiled->output_count;
+  for (int i = compiled->input_count; i < first_output; i++) {
+    if (compiled->groups.empty() || compiled->groups.back().end != i ||
+        layer_of[i] != layer_of[i - 1] ||
+        compiled->groups.back().activation != compiled->activations[i]) {
+      compiled->groups.push_back({i, i + 1, compiled->activations[i]});
+    } else {
+      compiled->groups.back().end++;
+    }
+  }
+  if (compiled->output_count > 0) {
+    compiled->groups.push_back({first_output, size, ActivationType::linear});
   }
-  ffneurons_ = ffneurons;
+
+  std::size_t hash = std::hash<int>()(compiled->input_count);
+  auto combine = [&hash](std::size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  };
+  combine(compiled->output_count);
+  for (int value : compiled->input_offsets) combine(value);
+  for (int value : compiled->input_sources) combine(value);
+  for (int value : compiled->cycle_offsets) combine(value);
+  for (int value : compiled->cycle_sources) combine(value);
+  for (const ActivationGroup &group : compiled->groups) {
+    combine(group.begin);
+    combine(group.end);
+    combine(static_cast<int>(group.activation));
+  }
+  compiled->shape_hash = hash;
+
+  // reduced precision copies, int8 weights are scaled per row so that the
+  // largest weight of every neuron maps to 127
+  compiled->bias_f.assign(compiled->bias.begin(), compiled->bias.end());
+  compiled->input_weights_f.assign(compiled->input_weights.begin(),
+                                   compiled->input_weights.end());
+  compiled->input_weights_q.resize(compiled->input_weights.size());
+  compiled->row_scales.assign(size, 0.0f);
+  for (int i = 0; i < size; i++) {
+    int begin = compiled->input_offsets[i], end = compiled->input_offsets[i + 1];
+    double largest = 0;
+    for (int k = begin; k < end; k++) {
+      largest = std::max(largest, std::fabs(compiled->input_weights[k]));
+    }
+    if (largest == 0) largest = 1;
+    compiled->row_scales[i] = static_cast<float>(largest / 127);
+    for (int k = begin; k < end; k++) {
+      compiled->input_weights_q[k] = static_cast<std::int8_t>(
+          std::lround(compiled->input_weights[k] * 127 / largest));
+    }
+  }
+  return compiled;
+}
+
+/*!
+ * @brief Reads a Precision from its name in the settings: "double", "float"
+ * or "int8". Unknown names select double precision.
+ */
+Precision ParsePrecision(const std::string &name) {
+  if (name == "float") return Precision::kFloat;
+  if (name == "int8") return Precision::kInt8;
+  return Precision::kDouble;
 }
 
+/*!
+ * @brief Checks whether two compiled networks only differ in their weights and
+ * biases.
+ *
+ * @details Networks of the same shape evaluate the exact same schedule, so
+ * they can be activated side by side by NeuralNetworkBatch.
+ */
+bool SameShape(const CompiledNetwork &a, const CompiledNetwork &b) {
+  if (&a == &b) return true;
+  if (a.shape_hash != b.shape_hash || a.input_count != b.input_count ||
+      a.output_count != b.output_count || a.size() != b.size() ||
+      a.groups.size() != b.groups.size()) {
+    return false;
+  }
+  for (int i = 0; i < a.groups.size(); i++) {
+    if (a.groups[i].begin != b.groups[i].begin ||
+        a.groups[i].end != b.groups[i].end ||
+        a.groups[i].activation != b.groups[i].activation) {
+      return false;
+    }
+  }
+  return a.input_offsets == b.input_offsets &&
+         a.input_sources == b.input_sources &&
+         a.cycle_offsets == b.cycle_offsets &&
+         a.cycle_sources == b.cycle_sources;
+}
+
+/*!
+ * @brief Constructs a NeuralNetwork from a given Genome.
+ *
+ * @details The compiled network is shared through the NetworkCache with every
+ * other brain built from an identical genome; only the recurrent state and the
+ * scratch values belong to this network.
+ *
+ * @param genome The Genome to construct the NeuralNetwork from.
+ */
+NeuralNetwork::NeuralNetwork(const Genome &genom)
+    : compiled_(NetworkCache::GetInstance().Get(genom)),
+      state_(compiled_->size(), 0.0),
+      values_(compiled_->size(), 0.0) {}
+
+/*!
+ * @brief Constructs a NeuralNetwork from a shared Genome.
+ *
+ * @details Same as the constructor taking a Genome, but the cache keeps a
+ * reference to the shared genome instead of a copy.
+ *
+ * @param genome The shared Genome to construct the NeuralNetwork from.
+ */
+NeuralNetwork::NeuralNetwork(std::shared_ptr<const Genome> genom)
+    : compiled_(NetworkCache::GetInstance().Get(std::move(genom))),
+      state_(compiled_->size(), 0.0),
+      values_(compiled_->size(), 0.0) {}
+
 /*!
  * @brief Activates the neural network with a given set of input values.
  *
- * @param input_values The input values to feed into the network.
+ * @details Writes the outputs into a caller-provided buffer, which is only
+ * resized when its size does not match, so steady-state calls do not allocate.
  *
- * @return A vector of output values after network activation.
+ * @param input_values The input values to feed into the network.
+ * @param output_values Buffer receiving the output values.
+ * @param precision Arithmetic used for the activation.
  */
-std::vector<double> NeuralNetwork::Activate(
-    const std::vector<double> &input_values) {
-  assert(input_values.size() == input_ids_.size());
-  std::unordered_map<int, double> values;
-  for (int i = 0; i < input_values.size(); i++) {
-    values[input_ids_[i]] = input_values[i];
-  }
-
-  for (const FeedForwardNeuron &ffneuron : ffneurons_) {
-    if (values.find(ffneuron.id) ==
-        values.end()) {  // if ffneuron is not already activated
-      double value = ffneuron.value;
-      for (const NeuronInput &input : ffneuron.inputs) {
-        // assert(values.find(input.input_id) != values.end()); //previous
-        // neurons have to be activated
-        if (values.find(input.input_id) != values.end()) {
-          value += values[input.input_id] * input.weight;
-        }
-      }
-      value += ffneuron.bias;
+void NeuralNetwork::Activate(const std::vector<double> &input_values,
+                             std::vector<double> &output_values,
+                             Precision precision) {
+  if (precision != Precision::kDouble) {
+    ActivateSingle(input_values, output_values,
+                   precision == Precision::kInt8);
+    return;
+  }
+  const CompiledNetwork &net = *compiled_;
+  assert(input_values.size() == net.input_count);
+  double *values = values_.data();
+  std::copy(input_values.begin(), input_values.end(), values);
 
-      if (std::find(output_ids_.begin(), output_ids_.end(), ffneuron.id) ==
-          output_ids_.end()) {
-        value = activation_function(ffneuron.activation , value);
+  for (const ActivationGroup &group : net.groups) {
+    for (int i = group.begin; i < group.end; i++) {
+      double value = state_[i];
+      for (int k = net.input_offsets[i]; k < net.input_offsets[i + 1]; k++) {
+        value += values[net.input_sources[k]] * net.input_weights[k];
       }
+      values[i] = value + net.bias[i];
+    }
+    activation_function(group.activation, values + group.begin,
+                        group.end - group.begin);
+  }
 
-      values[ffneuron.id] = value;
+  // update values stored by the neurons which start a cycle
+  for (int i = 0; i < net.size(); i++) {
+    for (int k = net.cycle_offsets[i]; k < net.cycle_offsets[i + 1]; k++) {
+      double source = values[net.cycle_sources[k]];
+      if (std::fabs(source) > 1e10) continue;
+      state_[i] += net.cycle_weights[k] * source;
     }
   }
-  // update values stored by ffneurons. this affects those neurons which start a
-  // cycle
-  for (FeedForwardNeuron &ffneuron : ffneurons_) {
-    // ffneuron.value = 0;
-    for (const NeuronInput &neuron_input : ffneuron.inputs_from_cycles) {
-        if (abs(values[neuron_input.input_id]) > 1e10) continue;
-        ffneuron.value += neuron_input.weight * values[neuron_input.input_id];
 
+  output_values.resize(net.output_count);
+  std::copy(values + net.size() - net.output_count, values + net.size(),
+            output_values.begin());
+}
+
+/*!
+ * @brief Activates the network in single precision.
+ *
+ * @details Same schedule as Activate, with float values and accumulation.
+ * Quantised weights are expanded with the scale of their row as they are
+ * read, the way NeuralNetworkBatch gathers them into lanes.
+ *
+ * @param input_values The input values to feed into the network.
+ * @param output_values Buffer receiving the output values.
+ * @param quantised Whether to read the int8 weights.
+ */
+void NeuralNetwork::ActivateSingle(const std::vector<double> &input_values,
+                                   std::vector<double> &output_values,
+                                   bool quantised) {
+  const CompiledNetwork &net = *compiled_;
+  assert(input_values.size() == net.input_count);
+  // only brains run in a reduced precision need the float values
+  values_f_.resize(net.size());
+  float *values = values_f_.data();
+  std::copy(input_values.begin(), input_values.end(), values);
+
+  for (const ActivationGroup &group : net.groups) {
+    for (int i = group.begin; i < group.end; i++) {
+      float value = static_cast<float>(state_[i]);
+      int begin = net.input_offsets[i], end = net.input_offsets[i + 1];
+      if (quantised) {
+        const float scale = net.row_scales[i];
+        for (int k = begin; k < end; k++) {
+          value += values[net.input_sources[k]] *
+                   (net.input_weights_q[k] * scale);
+        }
+      } else {
+        for (int k = begin; k < end; k++) {
+          value += values[net.input_sources[k]] * net.input_weights_f[k];
+        }
+      }
+      values[i] = value + net.bias_f[i];
     }
+    activation_function(group.activation, values + group.begin,
+                        group.end - group.begin);
   }
-  std::vector<double> result;
-  for (int i = 0; i < output_ids_.size(); i++) {
-    result.push_back(values[output_ids_[i]]);
+
+  for (int i = 0; i < net.size(); i++) {
+    for (int k = net.cycle_offsets[i]; k < net.cycle_offsets[i + 1]; k++) {
+      double source = values[net.cycle_sources[k]];
+      if (std::fabs(source) > 1e10) continue;
+      state_[i] += net.cycle_weights[k] * source;
+    }
   }
+
+  output_values.resize(net.output_count);
+  std::copy(values + net.size() - net.output_count, values + net.size(),
+            output_values.begin());
+}
+
+/*!
+ * @brief Activates the neural network with a given set of input values.
+ *
+ * @param input_values The input values to feed into the network.
+ *
+ * @return A vector of output values after network activation.
+ */
+std::vector<double> NeuralNetwork::Activate(
+    const std::vector<double> &input_values) {
+  std::vector<double> result;
+  Activate(input_values, result);
   return result;
 }
 
+int NeuralNetwork::GetInputCount() const { return compiled_->input_count; }
+
+int NeuralNetwork::GetOutputCount() const { return compiled_->output_count; }
+
+/*!
+ * @brief Whether the network has recurrent connections, in which case its
+ * outputs also depend on the previous activations.
+ */
+bool NeuralNetwork::IsRecurrent() const {
+  return !compiled_->cycle_sources.empty();
+}
+
+std::shared_ptr<const CompiledNetwork> NeuralNetwork::GetCompiled() const {
+  return compiled_;
+}
+
 /*!
  * @brief Constructs layers of neurons from a given Genome.
  *
+ * @details Layers are computed with a topological sort over the active,
+ * non-cyclic links (see compute_layers); within a layer neurons keep their
+ * order in the genome.
+ *
  * @param genome The Genome to construct the layers from.
  *
  * @return A vector of neuron layers, where each layer is a vector of Neuron.
  */
 std::vector<std::vector<Neuron> > get_layers(const Genome &genom) {
-  std::vector<std::vector<Neuron> > layers;
-  std::vector<Neuron> input_layer;
-  std::vector<Neuron> output_layer;
-  std::vector<int>
-      active;  // a neuron is active if all of its incoming neurons belong to an
-               // active layer. A layer is active if all of its neurons are
-               // active.
-               // input neurons are also active and they form an active layer
-  std::vector<Neuron> neurons = genom.GetNeurons();
-  std::vector<Link> links = genom.GetLinks();
-
-  for (const Neuron &neuron : neurons) {
-    if (neuron.GetType() == NeuronType::kInput) {
-      int inputid = neuron.GetId();
-      input_layer.push_back(neuron);
-      active.push_back(inputid);
-    }
-  }
-  layers.push_back(input_layer);
-
-  for (const Neuron &neuron : neurons) {
-    if (neuron.GetType() == NeuronType::kOutput) {
-      output_layer.push_back(neuron);
-    }
-  }
-  int N_neurons = neurons.size();  // total number of neurons in the network
-  while (active.size() < N_neurons - genom.GetOutputCount()) {
-    std::vector<Neuron> layer;
-    for (const Neuron &neuron : neurons) {
-      if (neuron.GetType() == NeuronType::kHidden &&
-          std::find(active.begin(), active.end(), neuron.GetId()) ==
-              active.end()) {
-        bool is_active = true;
-        for (const Link &link : links) {
-          if (link.IsActive() && !link.IsCyclic() &&
-              link.GetOutId() == neuron.GetId() &&
-              std::find(active.begin(), active.end(), link.GetInId()) ==
-                  active.end()) {
-            is_active = false;
-            break;
-          }
-        }
-        if (is_active) {
-          layer.push_back(neuron);
-        }
-      }
-    }
-    layers.push_back(layer);
-    for (std::vector<Neuron>::iterator i = layer.begin(); i != layer.end();
-         i++) {
-      active.push_back((*i).GetId());
+  const std::vector<Neuron> &neurons = genom.GetNeurons();
+  std::unordered_map<std::int64_t, int> index_of = index_neurons(neurons);
+  std::vector<char> keep(neurons.size(), 1);
+  std::vector<int> layer =
+      compute_layers(neurons, genom.GetLinks(), index_of, keep);
+
+  int layer_count = 2;
+  for (int l : layer) layer_count = std::max(layer_count, l + 1);
+  std::vector<std::vector<Neuron> > layers(layer_count);
+  for (int i = 0; i < neurons.size(); i++) {
+    if (neurons[i].GetType() == NeuronType::kOutput) {
+      layers.back().push_back(neurons[i]);
+    } else {
+      layers[layer[i]].push_back(neurons[i]);
     }
   }
-  layers.push_back(output_layer);
   return layers;
 }
 
+/*!
+ * @brief Expands the compiled network back into per-neuron form.
+ *
+ * @return The neurons in evaluation order, with their current cycle state.
+ */
 std::vector<FeedForwardNeuron> NeuralNetwork::GetNeurons() const {
-  return ffneurons_;
+  const CompiledNetwork &net = *compiled_;
+  std::vector<FeedForwardNeuron> ffneurons;
+  for (int i = 0; i < net.size(); i++) {
+    std::vector<NeuronInput> inputs;
+    for (int k = net.input_offsets[i]; k < net.input_offsets[i + 1]; k++) {
+      inputs.push_back({net.ids[net.input_sources[k]], net.input_weights[k]});
+    }
+    std::vector<NeuronInput> inputs_from_cycles;
+    for (int k = net.cycle_offsets[i]; k < net.cycle_offsets[i + 1]; k++) {
+      inputs_from_cycles.push_back(
+          {net.ids[net.cycle_sources[k]], net.cycle_weights[k]});
+    }
+    ffneurons.push_back({net.ids[i], net.bias[i], state_[i], inputs,
+                         inputs_from_cycles, net.activations[i]});
+  }
+  return ffneurons;
 }
 
 /*!
@@ -200,5 +596,53 @@ double activation_function(ActivationType n, double x) {
             return x;
     }
 }
+namespace {
+
+template <typename T>
+void apply_activation(ActivationType n, T *values, int count) {
+  const T zero = 0, one = 1, leak = static_cast<T>(0.1);
+  switch (n) {
+    case ActivationType::sigmoid:
+#pragma omp simd
+      for (int i = 0; i < count; i++) values[i] = one / (one + std::exp(-values[i]));
+      break;
+    case ActivationType::relu:
+#pragma omp simd
+      for (int i = 0; i < count; i++)
+        values[i] = values[i] > zero ? values[i] : zero;
+      break;
+    case ActivationType::leakyRelu:
+#pragma omp simd
+      for (int i = 0; i < count; i++)
+        values[i] = values[i] > leak * values[i] ? values[i] : leak * values[i];
+      break;
+    case ActivationType::binary:
+#pragma omp simd
+      for (int i = 0; i < count; i++) values[i] = (values[i] >= zero) ? one : zero;
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+/*!
+ * @brief Applies one activation function to a contiguous run of values.
+ *
+ * @param n The activation function.
+ * @param values Pointer to the first value, modified in place.
+ * @param count Number of values.
+ */
+void activation_function(ActivationType n, double *values, int count) {
+  apply_activation(n, values, count);
+}
+
+/*!
+ * @brief Single precision version of the above.
+ */
+void activation_function(ActivationType n, float *values, int count) {
+  apply_activation(n, values, count);
+}
 //double activation_function(double x) { return 1 / (1 + exp(-x)); }
 }  // end of namespace neat
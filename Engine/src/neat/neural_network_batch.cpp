@@ -0,0 +1,246 @@
+#include "neat/neural_network_batch.h"
+/*!
+ * @file neural_network_batch.cpp
+ *
+ * @brief Implements the lane-parallel activation of NeuralNetworks.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "core/thread_pool.h"
+
+namespace neat {
+
+/*!
+ * @brief Removes every queued network, keeping the buffers for the next batch.
+ */
+void NeuralNetworkBatch::Clear() {
+  entries_.clear();
+  order_.clear();
+  runs_.clear();
+}
+
+/*!
+ * @brief Queues a network for the next call to Activate.
+ *
+ * @details The buffers are referenced, not copied, and must stay alive until
+ * Activate returns.
+ *
+ * @param network The network to activate.
+ * @param input_values The input values to feed into the network.
+ * @param output_values Buffer receiving the output values.
+ */
+void NeuralNetworkBatch::Add(NeuralNetwork &network,
+                             const std::vector<double> &input_values,
+                             std::vector<double> &output_values) {
+  entries_.push_back({&network, &input_values, &output_values});
+}
+
+/*!
+ * @brief Selects the arithmetic of the next calls to Activate.
+ */
+void NeuralNetworkBatch::SetPrecision(Precision precision) {
+  precision_ = precision;
+}
+
+/*!
+ * @brief Enables or disables the measure of the drift of reduced precision
+ * outputs from the double precision ones.
+ */
+void NeuralNetworkBatch::SetValidation(bool validate) { validate_ = validate; }
+
+Precision NeuralNetworkBatch::GetPrecision() const { return precision_; }
+
+int NeuralNetworkBatch::GetSize() const { return entries_.size(); }
+
+double NeuralNetworkBatch::GetMaxDrift() const { return max_drift_; }
+
+double NeuralNetworkBatch::GetMeanDrift() const { return mean_drift_; }
+
+/*!
+ * @brief Activates every queued network.
+ *
+ * @details Entries are sorted by shape hash and split into runs of networks of
+ * identical shape. Runs are independent, so they are evaluated in parallel;
+ * single networks take the scalar path. Results match NeuralNetwork::Activate
+ * with the same precision exactly, the sums are accumulated in the same order.
+ */
+void NeuralNetworkBatch::Activate() {
+  order_.clear();
+  for (const Entry &entry : entries_) order_.push_back(&entry);
+  std::sort(order_.begin(), order_.end(), [](const Entry *a, const Entry *b) {
+    const CompiledNetwork *ca = a->network->compiled_.get();
+    const CompiledNetwork *cb = b->network->compiled_.get();
+    if (ca->shape_hash != cb->shape_hash) return ca->shape_hash < cb->shape_hash;
+    return ca < cb;
+  });
+
+  runs_.clear();
+  for (int i = 0; i < order_.size(); i++) {
+    if (runs_.empty() ||
+        !SameShape(*order_[runs_.back().first]->network->compiled_,
+                   *order_[i]->network->compiled_)) {
+      runs_.push_back({i, i + 1});
+    } else {
+      runs_.back().second = i + 1;
+    }
+  }
+  if (scratch_.size() < runs_.size()) scratch_.resize(runs_.size());
+
+  const bool validate = validate_ && precision_ != Precision::kDouble;
+  if (validate && reference_.size() < entries_.size()) {
+    reference_.resize(entries_.size());
+  }
+
+  // a run costs about one multiply-add per link and lane
+  ThreadPool::Global().ParallelForWeighted(
+      0, runs_.size(),
+      [this](int r) {
+        const CompiledNetwork &net =
+            *order_[runs_[r].first]->network->compiled_;
+        return static_cast<double>(runs_[r].second - runs_[r].first) *
+               (net.input_weights.size() + net.size());
+      },
+      [&](int r) {
+        int lanes = runs_[r].second - runs_[r].first;
+        const Entry *const *entries = order_.data() + runs_[r].first;
+        if (validate) {
+          for (int l = 0; l < lanes; l++) {
+            NeuralNetwork &network = *entries[l]->network;
+            std::vector<double> state = network.state_;
+            network.Activate(*entries[l]->input_values,
+                             reference_[entries[l] - entries_.data()]);
+            network.state_.swap(state);
+          }
+        }
+        if (lanes == 1) {
+          entries[0]->network->Activate(*entries[0]->input_values,
+                                        *entries[0]->output_values, precision_);
+        } else if (precision_ == Precision::kDouble) {
+          ActivateLanes(entries, lanes, scratch_[r].wide);
+        } else {
+          ActivateLanes(entries, lanes, scratch_[r].narrow);
+        }
+      });
+
+  max_drift_ = 0;
+  mean_drift_ = 0;
+  if (!validate) return;
+  struct Drift {
+    double max = 0, sum = 0;
+    long outputs = 0;
+  };
+  const Drift drift = ThreadPool::Global().ParallelReduce(
+      0, entries_.size(), Drift(),
+      [this](int e) {
+        Drift entry;
+        const std::vector<double> &output_values = *entries_[e].output_values;
+        for (int i = 0; i < output_values.size(); i++) {
+          double d = std::fabs(output_values[i] - reference_[e][i]);
+          entry.max = std::max(entry.max, d);
+          entry.sum += d;
+        }
+        entry.outputs = output_values.size();
+        return entry;
+      },
+      [](const Drift &a, const Drift &b) {
+        return Drift{std::max(a.max, b.max), a.sum + b.sum,
+                     a.outputs + b.outputs};
+      });
+  max_drift_ = drift.max;
+  if (drift.outputs > 0) mean_drift_ = drift.sum / drift.outputs;
+}
+
+/*!
+ * @brief Activates networks of identical shape side by side.
+ *
+ * @details T is double for Precision::kDouble and float otherwise; int8
+ * weights are expanded to floats when they are gathered into the lanes.
+ *
+ * @param entries The networks, all sharing one shape.
+ * @param lanes Number of networks.
+ * @param scratch Lane buffers reused between batches.
+ */
+template <typename T>
+void NeuralNetworkBatch::ActivateLanes(const Entry *const *entries, int lanes,
+                                       LaneBuffers<T> &scratch) {
+  const CompiledNetwork &net = *entries[0]->network->compiled_;
+  int size = net.size();
+  int links = net.input_sources.size();
+  scratch.values.resize(size * lanes);
+  scratch.state.resize(size * lanes);
+  scratch.bias.resize(size * lanes);
+  scratch.weights.resize(links * lanes);
+
+  // gather inputs, parameters and recurrent state into lanes
+  for (int l = 0; l < lanes; l++) {
+    const NeuralNetwork &network = *entries[l]->network;
+    const CompiledNetwork &lane_net = *network.compiled_;
+    const std::vector<double> &input_values = *entries[l]->input_values;
+    assert(input_values.size() == net.input_count);
+    for (int i = 0; i < net.input_count; i++) {
+      scratch.values[i * lanes + l] = input_values[i];
+    }
+    for (int i = 0; i < size; i++) {
+      scratch.state[i * lanes + l] = network.state_[i];
+      scratch.bias[i * lanes + l] = lane_net.bias[i];
+    }
+    if (precision_ == Precision::kInt8) {
+      for (int i = 0; i < size; i++) {
+        for (int k = net.input_offsets[i]; k < net.input_offsets[i + 1]; k++) {
+          scratch.weights[k * lanes + l] =
+              lane_net.input_weights_q[k] * lane_net.row_scales[i];
+        }
+      }
+    } else {
+      for (int k = 0; k < links; k++) {
+        scratch.weights[k * lanes + l] = lane_net.input_weights[k];
+      }
+    }
+  }
+
+  T *values = scratch.values.data();
+  const T *state = scratch.state.data();
+  const T *bias = scratch.bias.data();
+  const T *weights = scratch.weights.data();
+  for (const ActivationGroup &group : net.groups) {
+    for (int i = group.begin; i < group.end; i++) {
+      T *row = values + i * lanes;
+#pragma omp simd
+      for (int l = 0; l < lanes; l++) row[l] = state[i * lanes + l];
+      for (int k = net.input_offsets[i]; k < net.input_offsets[i + 1]; k++) {
+        const T *source = values + net.input_sources[k] * lanes;
+        const T *weight = weights + k * lanes;
+#pragma omp simd
+        for (int l = 0; l < lanes; l++) row[l] += source[l] * weight[l];
+      }
+#pragma omp simd
+      for (int l = 0; l < lanes; l++) row[l] += bias[i * lanes + l];
+    }
+    activation_function(group.activation, values + group.begin * lanes,
+                        (group.end - group.begin) * lanes);
+  }
+
+  // scatter recurrent state and outputs back to each network
+  int first_output = size - net.output_count;
+  for (int l = 0; l < lanes; l++) {
+    NeuralNetwork &network = *entries[l]->network;
+    const CompiledNetwork &lane_net = *network.compiled_;
+    for (int i = 0; i < size; i++) {
+      for (int k = net.cycle_offsets[i]; k < net.cycle_offsets[i + 1]; k++) {
+        double source = values[net.cycle_sources[k] * lanes + l];
+        if (std::fabs(source) > 1e10) continue;
+        network.state_[i] += lane_net.cycle_weights[k] * source;
+      }
+    }
+    std::vector<double> &output_values = *entries[l]->output_values;
+    output_values.resize(net.output_count);
+    for (int i = 0; i < net.output_count; i++) {
+      output_values[i] = values[(first_output + i) * lanes + l];
+    }
+  }
+}
+
+}  // end of namespace neat
@@ -5,13 +5,12 @@
  * @brief Defines the Neuron class and related functions for NEAT.
  */
 
+#include "core/id_service.h"
 #include "core/random.h"
 #include "stdexcept"
 
 namespace neat {
 
-int Neuron::next_id_ = 1;
-
 /*!
  * @brief Constructs a Neuron with specified type and bias.
  *
@@ -19,10 +18,10 @@ int Neuron::next_id_ = 1;
  * @param bias The bias of the neuron.
  */
 Neuron::Neuron(NeuronType type, double bias)
-    : id_(next_id_++), type_(type), bias_(bias), active_(true),
+    : id_(IdService::Next(IdService::kNeuron)), type_(type), bias_(bias), active_(true),
       activation_(ActivationType::linear){}
 
-Neuron::Neuron(int id, NeuronType type, double bias, bool active, ActivationType activation)
+Neuron::Neuron(std::int64_t id, NeuronType type, double bias, bool active, ActivationType activation)
     : id_(id), type_(type), bias_(bias), active_(active),
       activation_(activation){}
 
@@ -31,7 +30,7 @@ Neuron::Neuron(int id, NeuronType type, double bias, bool active, ActivationType
  *
  * @return The ID of the neuron.
  */
-int Neuron::GetId() const { return id_; }
+std::int64_t Neuron::GetId() const { return id_; }
 
 /*!
  * @brief Gets the type of the neuron.
@@ -107,7 +106,7 @@ Neuron CrossoverNeuron(const Neuron &a, const Neuron &b) {
     throw std::invalid_argument("Neurons must have the same type");
   }
 
-  int id = a.GetId();
+  std::int64_t id = a.GetId();
   NeuronType type = a.GetType();
 
   Neuron crossover_neuron = a;
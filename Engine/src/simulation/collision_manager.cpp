@@ -1,8 +1,9 @@
 #include "simulation/collision_manager.h"
 
-#include "core/settings.h"
+#include <mutex>
 
-#include <omp.h>
+#include "core/settings.h"
+#include "core/thread_pool.h"
 
 CollisionManager::CollisionManager() {}
 
@@ -13,7 +14,7 @@ CollisionManager::CollisionManager() {}
  * different entities.
  */
 void CollisionManager::CheckCollisions(EntityGrid& entity_grid) {
-  auto grid = entity_grid.GetGrid();
+  auto& grid = entity_grid.GetGrid();
 
   double tolerance = SETTINGS.environment.tolerance;
 
@@ -21,30 +22,28 @@ void CollisionManager::CheckCollisions(EntityGrid& entity_grid) {
   int num_rows = entity_grid_size.first;
   int num_cols = entity_grid_size.second;
 
-  #pragma omp parallel for collapse(2)
-  for (int row = 0; row < num_rows; row++) {
-    for (int col = 0; col < num_cols; col++) {
-      for (auto entity1 : grid[col][row]) {
-        const int layer_number =
-            2 *
-            ceil((entity1->GetSize() / SETTINGS.environment.grid_cell_size));
-
-        std::vector<std::pair<int, int>> neighbours =
-            entity_grid.GetNeighbours({col, row}, layer_number);
-        for (const std::pair<int, int> neighbour : neighbours) {
-          for (auto entity2 : grid[neighbour.first][neighbour.second]) {
-            if (entity1->CheckCollisionWithEntity(tolerance, entity2)) {
-              if (entity1 != entity2) {
-                #pragma omp critical
-                {
-                  entity1->OnCollision(entity2, SETTINGS.environment.map_width,
-                                       SETTINGS.environment.map_height);
-                }
-              }
+  std::mutex collision_mutex;
+  ThreadPool::Global().ParallelFor(0, num_rows * num_cols, [&](int cell) {
+    const int row = cell / num_cols, col = cell % num_cols;
+    // shared by the entities of the cell, it only grows for larger ones
+    ScratchVector<std::pair<int, int>> neighbours;
+    for (auto entity1 : grid[col][row]) {
+      const int layer_number =
+          2 *
+          ceil((entity1->GetSize() / SETTINGS.environment.grid_cell_size));
+
+      entity_grid.GetNeighbours({col, row}, layer_number, neighbours);
+      for (const std::pair<int, int> neighbour : neighbours) {
+        for (auto entity2 : grid[neighbour.first][neighbour.second]) {
+          if (entity1->CheckCollisionWithEntity(tolerance, entity2)) {
+            if (entity1 != entity2) {
+              std::lock_guard<std::mutex> lock(collision_mutex);
+              entity1->OnCollision(entity2, SETTINGS.environment.map_width,
+                                   SETTINGS.environment.map_height);
             }
           }
         }
       }
     }
-  }
+  });
 }
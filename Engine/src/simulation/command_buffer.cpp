@@ -0,0 +1,161 @@
+#include "simulation/command_buffer.h"
+
+#include <algorithm>
+
+#include "core/thread_pool.h"
+#include "simulation/simulation_data.h"
+
+namespace {
+
+/*!
+ * @brief Concatenates one kind of command of every buffer, sorted by key.
+ *
+ * @details The sort is stable and the buffers are visited in thread order, so
+ * commands sharing a key keep the order in which one thread recorded them.
+ */
+template <typename Keyed, typename Member>
+std::vector<Keyed> Merge(std::vector<CommandBuffer>& buffers, Member member) {
+  std::vector<Keyed> merged;
+  for (CommandBuffer& buffer : buffers) {
+    auto& commands = buffer.*member;
+    merged.insert(merged.end(), commands.begin(), commands.end());
+  }
+  std::stable_sort(merged.begin(), merged.end(),
+                   [](const Keyed& a, const Keyed& b) { return a.key < b.key; });
+  return merged;
+}
+
+}  // namespace
+
+/*!
+ * @brief Records a creature to be added to the simulation.
+ */
+void CommandBuffer::Spawn(std::shared_ptr<Creature> creature) {
+  creatures_.push_back({key_, std::move(creature)});
+}
+
+/*!
+ * @brief Records an egg to be added to the simulation.
+ */
+void CommandBuffer::Spawn(std::shared_ptr<Egg> egg) {
+  eggs_.push_back({key_, std::move(egg)});
+}
+
+/*!
+ * @brief Records a food entity to be added to the simulation.
+ */
+void CommandBuffer::Spawn(std::shared_ptr<Food> food) {
+  food_.push_back({key_, std::move(food)});
+}
+
+/*!
+ * @brief Records a pheromone to be added to the simulation.
+ */
+void CommandBuffer::Spawn(std::shared_ptr<Pheromone> pheromone) {
+  pheromones_.push_back({key_, std::move(pheromone)});
+}
+
+/*!
+ * @brief Records an entity to be removed from the simulation.
+ */
+void CommandBuffer::Despawn(std::shared_ptr<Entity> entity) {
+  despawns_.push_back({key_, std::move(entity)});
+}
+
+/*!
+ * @brief Records an entity to be replaced by food, e.g. a dead creature by
+ * its meat.
+ *
+ * @param entity The entity to remove.
+ * @param remains The food left in its place.
+ */
+void CommandBuffer::Transform(std::shared_ptr<Entity> entity,
+                              std::shared_ptr<Food> remains) {
+  Despawn(std::move(entity));
+  Spawn(std::move(remains));
+}
+
+bool CommandBuffer::Empty() const {
+  return creatures_.empty() && eggs_.empty() && food_.empty() &&
+         pheromones_.empty() && despawns_.empty();
+}
+
+/*!
+ * @brief Drops every command, keeping the memory for the next tick.
+ */
+void CommandBuffer::Clear() {
+  creatures_.clear();
+  eggs_.clear();
+  food_.clear();
+  pheromones_.clear();
+  despawns_.clear();
+}
+
+CommandBuffers::CommandBuffers()
+    : buffers_(ThreadPool::Global().GetThreadCount()) {}
+
+/*!
+ * @brief Starts a new loop: its commands are applied after those of the
+ * previous loops. Call outside parallel regions.
+ */
+void CommandBuffers::BeginPhase() {
+  phase_++;
+  if (buffers_.size() < ThreadPool::Global().GetThreadCount()) {
+    buffers_.resize(ThreadPool::Global().GetThreadCount());
+  }
+}
+
+/*!
+ * @brief Returns the buffer of the calling thread, recording with a key.
+ *
+ * @param key Position of the commands within the current phase, usually the
+ * index of the loop iteration recording them.
+ *
+ * @return The buffer of the calling thread.
+ */
+CommandBuffer& CommandBuffers::Local(int key) {
+  CommandBuffer& buffer = buffers_[ThreadPool::ThreadIndex()];
+  buffer.key_ = (phase_ << 32) + key;
+  return buffer;
+}
+
+/*!
+ * @brief Applies and clears every recorded command. Call outside parallel
+ * regions.
+ *
+ * @param data The simulation to change.
+ */
+void CommandBuffers::Apply(SimulationData& data) {
+  for (const auto& command :
+       Merge<CommandBuffer::Keyed<std::shared_ptr<Entity>>>(
+           buffers_, &CommandBuffer::despawns_)) {
+    command.value->SetState(Entity::Dead);
+  }
+  for (const auto& command :
+       Merge<CommandBuffer::Keyed<std::shared_ptr<Creature>>>(
+           buffers_, &CommandBuffer::creatures_)) {
+    data.creatures_.push_back(command.value);
+  }
+  for (const auto& command : Merge<CommandBuffer::Keyed<std::shared_ptr<Egg>>>(
+           buffers_, &CommandBuffer::eggs_)) {
+    data.eggs_.push_back(command.value);
+  }
+  for (const auto& command :
+       Merge<CommandBuffer::Keyed<std::shared_ptr<Food>>>(
+           buffers_, &CommandBuffer::food_)) {
+    data.food_entities_.push_back(command.value);
+  }
+  for (const auto& command :
+       Merge<CommandBuffer::Keyed<std::shared_ptr<Pheromone>>>(
+           buffers_, &CommandBuffer::pheromones_)) {
+    data.pheromones_.push_back(command.value);
+  }
+
+  for (CommandBuffer& buffer : buffers_) buffer.Clear();
+  phase_ = 0;
+}
+
+bool CommandBuffers::Empty() const {
+  return std::all_of(buffers_.begin(), buffers_.end(),
+                     [](const CommandBuffer& buffer) { return buffer.Empty(); });
+}
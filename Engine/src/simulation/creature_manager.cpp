@@ -1,159 +1,269 @@
 #include "simulation/creature_manager.h"
 
+#include <algorithm>
+
+#include "core/id_service.h"
+#include "core/random.h"
 #include "core/settings.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+// Cost of a Sense which scans the surroundings, relative to one which doesn't
+constexpr double kThinkCost = 50;
+
+// Mutations of the offspring genome in a conception, see Conceive
+constexpr int kMutationsPerConception = 2;
 
-#include <omp.h>
+}  // namespace
 
 CreatureManager::CreatureManager() {}
 
 /*!
  * @brief Updates the state of all creatures for a given time interval.
  *
+ * @details Two phases. In the read phase every creature senses and thinks on
+ * the kinematics of the last tick, the ones the grid was built from; nothing
+ * a creature reads from the others is written. In the write phase each
+ * creature acts, its motion is integrated into the back buffer of the
+ * locomotion batch and its metabolism updated, touching only its own state.
+ * The new kinematics are published by a single swap, so every loop is free of
+ * races. The loops drawing random numbers, the vision of the thinkers and the
+ * structural pass, seed each creature from a per-tick seed and its index, so
+ * the result does not depend on the scheduling either.
+ *
  * @param deltaTime The time interval for which the creatures' states are
  * updated.
  */
-
 void CreatureManager::UpdateAllCreatures(SimulationData& data,
                                          Environment& environment,
                                          EntityGrid& entity_grid,
                                          double deltaTime) {
-  auto grid = entity_grid.GetGrid();
-  #pragma omp parallel for
-  for (auto& egg : data.eggs_) {
-    egg->Update(deltaTime);
-  }
-  // Vector to store thread-local reproduce lists
-  std::vector<std::vector<std::shared_ptr<Creature>>> local_reproduce_lists(omp_get_max_threads());
-  std::vector<std::vector<std::shared_ptr<Pheromone>>> local_pheromone_lists(omp_get_max_threads());
+  auto& grid = entity_grid.GetGrid();
+  const std::uint64_t kSenseSeed = Random::Bits();
+  const std::uint64_t kStructureSeed = Random::Bits();
+  const std::uint64_t kSpawnSeed = Random::Bits();
+  ThreadPool::Global().ParallelFor(0, data.eggs_.size(), [&](int i) {
+    data.eggs_[i]->Update(deltaTime);
+  });
 
-  #pragma omp parallel for
+  // Read phase: sensing, the creatures which think this tick queue their
+  // brains so they are all activated together. Only the thinkers scan their
+  // surroundings, the chunks are balanced on that.
+  thinking_.assign(data.creatures_.size(), 0);
+  ThreadPool::Global().ParallelForWeighted(
+      0, data.creatures_.size(),
+      [&](int i) {
+        return data.creatures_[i]->ThinksNextSense() ? kThinkCost : 1.0;
+      },
+      [&](int i) {
+        auto& creature = data.creatures_[i];
+        // only the thinkers draw, for the empty slots of their vision
+        std::optional<Random::ScopedSeed> seed;
+        if (creature->ThinksNextSense()) seed.emplace(kSenseSeed, i);
+        thinking_[i] = creature->Sense(
+            grid, SETTINGS.environment.grid_cell_size,
+            SETTINGS.environment.map_width, SETTINGS.environment.map_height);
+      });
+
+  brain_batch_.Clear();
+  brain_batch_.SetPrecision(
+      neat::ParsePrecision(SETTINGS.engine.brain_precision));
+  brain_batch_.SetValidation(SETTINGS.engine.validate_brain_precision);
   for (int i = 0; i < data.creatures_.size(); ++i) {
+    if (!thinking_[i]) continue;
+    thinks_++;
+    if (!data.creatures_[i]->QueueThink(brain_batch_)) skipped_thinks_++;
+  }
+  brain_batch_.Activate();
+
+  // Write phase: each creature only touches its own state
+  ThreadPool::Global().ParallelFor(0, data.creatures_.size(), [&](int i) {
+    if (thinking_[i]) data.creatures_[i]->Act();
+  });
+
+  // Kinematics of all the creatures in one kernel, into the back buffer
+  locomotion_batch_.Clear();
+  for (auto& creature : data.creatures_) {
+    creature->QueueKinematics(locomotion_batch_,
+                              environment.GetFrictionalCoefficient());
+  }
+  locomotion_batch_.Integrate(deltaTime, SETTINGS.environment.map_width,
+                              SETTINGS.environment.map_height);
+
+  // Metabolism of all the creatures in one kernel
+  metabolism_batch_.Clear();
+  for (auto& creature : data.creatures_) {
+    metabolism_batch_.Add(*creature);
+  }
+  metabolism_batch_.Step(deltaTime);
+  const std::vector<char>& deaths = metabolism_batch_.GetDeaths();
+
+  locomotion_batch_.Swap();
+
+  // Structural changes go through the command buffers and are applied at the
+  // end of the tick. The creatures first draw what they spawn, so each takes
+  // exactly the entity ids it needs, from a range set by its index.
+  spawns_.assign(data.creatures_.size() + 1, 0);
+  ThreadPool::Global().ParallelFor(0, data.creatures_.size(), [&](int i) {
     auto& creature = data.creatures_[i];
-    creature->Update(deltaTime, SETTINGS.environment.map_width,
-                     SETTINGS.environment.map_height, grid,
-                     SETTINGS.environment.grid_cell_size,
-                     environment.GetFrictionalCoefficient());
+    Random::ScopedSeed seed(kStructureSeed, i);
 
     if (creature->GetMatingDesire() && !creature->WaitingToReproduce()) {
-      int thread_id = omp_get_thread_num();
-      local_reproduce_lists[thread_id].push_back(creature);
       creature->SetWaitingToReproduce(true);
     }
 
+    spawns_[i + 1] = creature->DrawPheromones(deltaTime) +
+                     creature->FemaleReproductiveSystem::CanBirth() +
+                     deaths[i];
+  });
+  for (int i = 0; i < data.creatures_.size(); ++i) {
+    spawns_[i + 1] += spawns_[i];
+  }
+  const std::int64_t first_id =
+      IdService::Reserve(IdService::kEntity, spawns_.back());
+
+  data.commands_.BeginPhase();
+  ThreadPool::Global().ParallelFor(0, data.creatures_.size(), [&](int i) {
+    if (spawns_[i] == spawns_[i + 1]) return;
+    auto& creature = data.creatures_[i];
+    CommandBuffer& commands = data.commands_.Local(i);
+    Random::ScopedSeed seed(kSpawnSeed, i);
+    IdService::ScopedJob job(IdService::kEntity, first_id + spawns_[i],
+                             spawns_[i + 1] - spawns_[i]);
+
     if (creature->FemaleReproductiveSystem::CanBirth()) {
-      std::cerr << "Creature is ready to give birth" << std::endl;
-      data.eggs_.push_back(creature->FemaleReproductiveSystem::GiveBirth(
+      commands.Spawn(creature->FemaleReproductiveSystem::GiveBirth(
           creature->GetCoordinates()));
     }
-    std::vector<std::shared_ptr<Pheromone>> emissions = creature->EmitPheromones(deltaTime);
-        local_pheromone_lists[omp_get_thread_num()].insert(
-            local_pheromone_lists[omp_get_thread_num()].end(),
-            emissions.begin(), emissions.end());
-  }
-
-  // Merge thread-local lists into the global reproduce list
-  for (auto &list : local_reproduce_lists) {
-    for (auto &creature : list) {
-      data.new_reproduce_.push(creature);
+    for (auto& pheromone : creature->EmitPheromones()) {
+      commands.Spawn(pheromone);
     }
-  }
 
-  for (auto &list : local_pheromone_lists) {
-      data.pheromones_.insert(data.pheromones_.end(), list.begin(), list.end());
-  }
+    if (deaths[i]) {
+      // dead creatures turn into meat
+      commands.Transform(creature, std::make_shared<Meat>(
+                                       creature->GetCoordinates().first,
+                                       creature->GetCoordinates().second,
+                                       creature->GetSize()));
+    }
+  });
 }
 
+/*!
+ * @brief Hatches the eggs that finished incubating.
+ *
+ * @details The hatchlings, whose brains are built on construction, are created
+ * in parallel, each job with its own seed and the entity id reserved for its
+ * egg. Species are then assigned and the hatchlings spawned in egg order.
+ */
 void CreatureManager::HatchEggs(SimulationData& data, Environment& environment) {
-  for (auto& egg : data.eggs_) {
-      if (egg->GetAge() >= egg->GetIncubationTime()){
-          std::shared_ptr<Creature> new_creature = egg->Hatch();
-          std::cerr << "Hatched creature" << std::endl;
-          data.creatures_.push_back(new_creature);
-          egg->SetState(Entity::Dead);
+  hatchlings_.assign(data.eggs_.size(), nullptr);
+  const std::uint64_t kBatchSeed = Random::Bits();
+  const IdService::Batch ids =
+      IdService::ReserveBatch(data.eggs_.size(), {1, 0, 0});
+  ThreadPool::Global().ParallelFor(0, data.eggs_.size(), [&](int i) {
+      auto& egg = data.eggs_[i];
+      if (egg->GetState() == Entity::Alive &&
+          egg->GetAge() >= egg->GetIncubationTime()){
+          Random::ScopedSeed seed(kBatchSeed, i);
+          IdService::ScopedJob job(ids, i);
+          hatchlings_[i] = egg->Hatch();
       }
+  }, 1);
+
+  data.commands_.BeginPhase();
+  for (int i = 0; i < data.eggs_.size(); ++i) {
+      if (!hatchlings_[i]) continue;
+      species_manager_.Assign(*hatchlings_[i]);
+      CommandBuffer& commands = data.commands_.Local(i);
+      commands.Spawn(hatchlings_[i]);
+      commands.Despawn(data.eggs_[i]);
   }
-  data.eggs_.erase(std::remove_if(data.eggs_.begin(), data.eggs_.end(), [](auto& egg) {
-      return egg->GetState() == Entity::Dead;}), data.eggs_.end());
+  hatchlings_.clear();
+  species_manager_.Refresh(data);
+}
+
+const SpeciesManager& CreatureManager::GetSpeciesManager() const {
+  return species_manager_;
+}
+
+/*!
+ * @brief The batch activating the brains, with the drift of the last tick
+ * when the brain precision is validated.
+ */
+const neat::NeuralNetworkBatch& CreatureManager::GetBrainBatch() const {
+  return brain_batch_;
+}
+
+long CreatureManager::GetThinks() const { return thinks_; }
+
+long CreatureManager::GetSkippedThinks() const { return skipped_thinks_; }
+
+/*!
+ * @brief Fraction of the thinks which reused the outputs of the previous
+ * activation, see Creature::QueueThink.
+ */
+double CreatureManager::GetThinkSkipRate() const {
+  return thinks_ == 0 ? 0.0 : static_cast<double>(skipped_thinks_) / thinks_;
 }
 
 /*!
  * @brief Handles the reproduction process of creatures in the simulation.
  *
- * @details Pairs creatures by compatibility from the reproduction queue and
- * creates offspring with crossed-over genomes.
+ * @details Pairs the creatures waiting to reproduce with compatible partners
+ * nearby, see MateMatcher. The offspring of all pairs, crossover and mutation,
+ * are conceived as a batch of parallel jobs, each seeded from the batch seed
+ * and its index and taking its neuron and link ids from the range of its
+ * index, so the result doesn't depend on the schedule. The parents are then
+ * updated serially in pair order.
  */
 void CreatureManager::ReproduceCreatures(SimulationData& data,
                                          Environment& environment) {
-    std::queue<std::shared_ptr<Creature>> not_reproduced;
-
-    while (!data.reproduce_.empty()) {
-      auto creature1 = data.reproduce_.front();
-      data.reproduce_.pop();
-      bool paired = false;
-      bool readded = false;  // Flag to track if creature1 is re-added to the queue
-
-      std::queue<std::shared_ptr<Creature>> next_round_queue;
-      while (!data.new_reproduce_.empty() && !paired) {
-        auto creature2 = data.new_reproduce_.front();
-        data.new_reproduce_.pop();
-
-        if (creature1->Compatible(creature2) &&
-            creature1->MaleReproductiveSystem::ReadyToProcreate() &&
-            creature2->FemaleReproductiveSystem::ReadyToProcreate()) {
-          if (creature1->GetDistance(creature2) < SETTINGS.compatibility.compatibility_distance) {
-            std::cerr << "Reproducing creatures" << std::endl;
-            ReproduceTwoCreatures(data, creature1, creature2);
-            paired = true;
-          } else {
-            // Compatible but not close enough, add both back for next round
-            next_round_queue.push(creature1);
-            next_round_queue.push(creature2);
-            readded = true;  // Mark creature1 as re-added
-            break; // Break out of the loop to prevent re-pairing of creature1
-          }
-        } else {
-          next_round_queue.push(creature2);  // Save for next round
-        }
-      }
+  std::vector<MatePair> pairs = mate_matcher_.Match(data.creatures_);
+  if (pairs.empty()) return;
 
-      // If creature1 wasn't paired and not re-added, add it to not_reproduced
-      if (!paired && !readded) {
-        not_reproduced.push(creature1);
-      }
-
-      // Refill new_reproduce_ with unpaired creatures for the next attempt
-      while (!next_round_queue.empty()) {
-        data.new_reproduce_.push(next_round_queue.front());
-        next_round_queue.pop();
-      }
-    }
-
-    // Refill reproduce_ with creatures for the next iteration
-    while (!data.new_reproduce_.empty()) {
-      data.reproduce_.push(data.new_reproduce_.front());
-      data.new_reproduce_.pop();
-    }
+  conceptions_.clear();
+  conceptions_.resize(pairs.size());
+  const std::uint64_t kBatchSeed = Random::Bits();
+  // the offspring can evolve the modules still available to either parent
+  int neurons_per_mutation = 0;
+  for (const MatePair& pair : pairs) {
+    neurons_per_mutation =
+        std::max({neurons_per_mutation,
+                  pair.father->GetGenome().MaxNeuronsPerMutation(),
+                  pair.mother->GetGenome().MaxNeuronsPerMutation()});
+  }
+  const IdService::Batch ids = IdService::ReserveBatch(
+      pairs.size(),
+      {0, kMutationsPerConception * neurons_per_mutation,
+       kMutationsPerConception * neat::Genome::kMaxLinksPerMutation});
+  ThreadPool::Global().ParallelFor(0, pairs.size(), [&](int i) {
+    Random::ScopedSeed seed(kBatchSeed, i);
+    IdService::ScopedJob job(ids, i);
+    conceptions_[i].emplace(Conceive(*pairs[i].father, *pairs[i].mother));
+  }, 1);
 
-    // Refill reproduce_ with the remaining creatures
-    while (!not_reproduced.empty()) {
-      data.reproduce_.push(not_reproduced.front());
-      not_reproduced.pop();
-    }
+  for (int i = 0; i < pairs.size(); ++i) {
+    ReproduceTwoCreatures(data, pairs[i].father, pairs[i].mother,
+                          std::move(*conceptions_[i]));
+  }
+  conceptions_.clear();
 }
 
 /*!
  *  @brief Reproduces two creatures and adds a descendant to the simulation
  *
- *  @details Takes two creatures and uses the crossover functions for genomes
- * and mutables to create a child creature out of the previous two. We take as
- * the dominant creature for the algorithms that that has the highest energy at
- * the moment of reproduction
+ *  @details Takes two creatures and the egg conceived from them, see Conceive,
+ * makes the mother pregnant with it and charges both parents the cost of
+ * mating.
  */
 void CreatureManager::ReproduceTwoCreatures(SimulationData& data,
                                             std::shared_ptr<Creature> father,
-                                            std::shared_ptr<Creature> mother) {
+                                            std::shared_ptr<Creature> mother,
+                                            GestatingEgg egg) {
   father->MaleReproductiveSystem::MateWithFemale();
-  mother->FemaleReproductiveSystem::MateWithMale(father, mother);
+  mother->FemaleReproductiveSystem::MateWithMale(std::move(egg));
   father->SetWaitingToReproduce(false);
   mother->SetWaitingToReproduce(false);
   father->MaleAfterMate();
@@ -176,18 +286,20 @@ void CreatureManager::InitializeCreatures(SimulationData& data,
   double min_creature_size = SETTINGS.environment.min_creature_size;
 
   data.creatures_.clear();
+  species_manager_.Clear();
   int creatures_genome_ = 0;
-  neat::Genome genome(SETTINGS.environment.input_neurons,
-                      SETTINGS.environment.output_neurons);
+  std::shared_ptr<const neat::Genome> genome;
   for (double x = 0; x < world_width; x += 2.0) {
     for (double y = 0; y < world_height; y += 2.0) {
       if (std::rand() / (RAND_MAX + 1.0) < creature_density) {
         if(creatures_genome_ % 3 == 0){
-          genome = neat::Genome(SETTINGS.environment.input_neurons,
-                                SETTINGS.environment.output_neurons);
+          auto new_genome = std::make_shared<neat::Genome>(
+              SETTINGS.environment.input_neurons,
+              SETTINGS.environment.output_neurons);
           for(int i = 0; i < 10; i++){
-            genome.Mutate();
+            new_genome->Mutate();
           }
+          genome = new_genome;
         }
         creatures_genome_++;
         Mutable mutables;
@@ -196,6 +308,7 @@ void CreatureManager::InitializeCreatures(SimulationData& data,
         }
         std::shared_ptr<Creature> new_creature = std::make_shared<Creature>(genome, mutables);
         new_creature->RandomInitialization(world_width, world_height);
+        species_manager_.Assign(*new_creature);
         data.creatures_.push_back(new_creature);
       }
     }
@@ -57,8 +57,11 @@ void UpdateGridFood(std::vector<std::shared_ptr<Food>> &foods,
 }
 
 /*!
- * @brief Function that turns the dead creatures to meat from their
- * corresponding vectors and fills the grid with the remaining entities.
+ * @brief Function that erases the dead creatures from their corresponding
+ * vector and fills the grid with the remaining entities.
+ *
+ * @details Their meat is spawned through the command buffers by
+ * CreatureManager::UpdateAllCreatures.
  *
  * @param creatures Vector of type Creature.
  * @param entityGrid 3D vector of entities.
@@ -70,16 +73,6 @@ void UpdateGridCreature(
         std::vector<std::shared_ptr<Creature>> &creatures,
         std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &entityGrid,
         double cellSize, std::vector<std::shared_ptr<Food>> &food) {
-    for (auto &creature : creatures) {
-        if (creature->GetState() == Entity::Dead) {
-            // Convert dead creatures to meat and add to the food vector
-            food.push_back(std::make_shared<Meat>(creature->GetCoordinates().first,
-                                                  creature->GetCoordinates().second,
-                                                  creature->GetSize()));
-            // Creature will be removed in the next erase-remove call
-        }
-    }
-
     creatures.erase(std::remove_if(creatures.begin(), creatures.end(),
                                     [](const std::shared_ptr<Creature> creature) {
                                         return creature->GetState() == Entity::Dead;
@@ -95,28 +88,6 @@ void UpdateGridCreature(
     }
 }
 
-/*!
- * @brief Removes creatures with a state of 'Dead' from a given queue.
- *
- * @param reproduce A queue of Creature objects, potentially containing dead
- * creatures.
- */
-void UpdateQueue(std::queue<std::shared_ptr<Creature>> &reproduce) {
-    std::queue<std::shared_ptr<Creature>> tempQueue;
-
-    while (!reproduce.empty()) {
-        auto currentCreature = reproduce.front();
-        reproduce.pop();
-
-        if (currentCreature->GetState() != Entity::Dead) {
-            tempQueue.push(currentCreature);
-        }
-        // Dead creatures are not re-added to the queue and will be destroyed
-    }
-
-    reproduce = std::move(tempQueue);
-}
-
 void UpdateGridPheromones(
         std::vector<std::shared_ptr<Pheromone>> &pheromones,
         std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>>& entityGrid,
@@ -180,7 +151,6 @@ void EntityGrid::UpdateGrid(SimulationData &data, Environment &environment, doub
     UpdateGridCreature(data.creatures_, grid_, SETTINGS.environment.grid_cell_size, data.food_entities_);
     UpdateGridFood(data.food_entities_, grid_, SETTINGS.environment.grid_cell_size);
     UpdateGridEgg(data.eggs_, grid_, SETTINGS.environment.grid_cell_size);
-    UpdateQueue(data.reproduce_);
     UpdateGridPheromones(data.pheromones_, grid_, SETTINGS.environment.grid_cell_size, deltaTime);
 }
 
@@ -217,7 +187,25 @@ const std::pair<int, int> EntityGrid::GetGridSize() const {
  */
 std::vector<std::pair<int, int>> EntityGrid::GetNeighbours(
     const std::pair<int, int> &center, const int &layer_number) {
-  std::vector<std::pair<int, int>> neighbours;
+  ScratchVector<std::pair<int, int>> neighbours;
+  GetNeighbours(center, layer_number, neighbours);
+  return {neighbours.begin(), neighbours.end()};
+}
+
+/*!
+ * @brief Same as GetNeighbours, into a vector of the scratch arena.
+ *
+ * @details The vector is reserved for the whole square up front: the arena
+ * never frees, so growing by push_back would leave every smaller buffer
+ * behind until the end of the tick.
+ *
+ * @param neighbours Replaced by the neighbouring cells.
+ */
+void EntityGrid::GetNeighbours(
+    const std::pair<int, int> &center, int layer_number,
+    ScratchVector<std::pair<int, int>> &neighbours) const {
+  neighbours.clear();
+  neighbours.reserve((2 * layer_number + 1) * (2 * layer_number + 1));
   int x_center = center.first;
   int y_center = center.second;
 
@@ -227,9 +215,12 @@ std::vector<std::pair<int, int>> EntityGrid::GetNeighbours(
                                           (y + num_rows_) % num_rows_));
     }
   }
-  return neighbours;
 }
 
-std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> EntityGrid::GetGrid() const {
+std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &EntityGrid::GetGrid() {
+  return grid_;
+}
+
+const std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> &EntityGrid::GetGrid() const {
   return grid_;
 }
@@ -1,8 +1,9 @@
 #include "simulation/food_manager.h"
 
+#include "core/id_service.h"
 #include "core/settings.h"
 #include "core/random.h"
-#include <omp.h>
+#include "core/thread_pool.h"
 
 FoodManager::FoodManager() {}
 
@@ -15,27 +16,29 @@ void FoodManager::InitializeFood(SimulationData &data,
   for (int i = 0; i < 500; i++) {
     GenerateMoreFood(data, environment, 3);
   }
+  data.commands_.Apply(data);
 }
 
 /*!
  * @brief Generates additional food entities based on the environment's food
  * density.
+ *
+ * @details The new plants are recorded in the command buffers and join the
+ * simulation when they are applied. Each column of spawn cells is a job with
+ * its own seed and entity ids, so the plants don't depend on the schedule.
  */
 void FoodManager::GenerateMoreFood(SimulationData &data, Environment &environment, double deltaTime) {
     double spawn_cell_size = 50.0;
     int width = SETTINGS.environment.map_width / spawn_cell_size;
     int height = SETTINGS.environment.map_height / spawn_cell_size;
 
-    // We create a vector of vectors, each sub-vector will be used by a single thread to store new plants
-    std::vector<std::vector<std::shared_ptr<Plant>>> local_plants(omp_get_max_threads());
-    Random::InitializeThreadLocalEngine();
-
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < width; i++) {
+    data.commands_.BeginPhase();
+    const std::uint64_t kBatchSeed = Random::Bits();
+    const IdService::Batch ids = IdService::ReserveBatch(width, {height, 0, 0});
+    ThreadPool::Global().ParallelFor(0, width, [&](int i) {
+      Random::ScopedSeed seed(kBatchSeed, i);
+      IdService::ScopedJob job(ids, i);
       for (int j = 0; j < height; j++) {
-        // Get the thread ID
-        int tid = omp_get_thread_num();
-
         double x_coord = i * spawn_cell_size;
         double y_coord = j * spawn_cell_size;
         double food_density = environment.GetFoodDensity(x_coord, y_coord);
@@ -48,18 +51,11 @@ void FoodManager::GenerateMoreFood(SimulationData &data, Environment &environmen
         if (random_number < food_spawn_probability) {
           double x_pos = x_coord + Random::Double(0, 1) * spawn_cell_size;
           double y_pos = y_coord + Random::Double(0, 1) * spawn_cell_size;
-          local_plants[tid].push_back(std::make_shared<Plant>(x_pos, y_pos));
+          data.commands_.Local(i * height + j)
+              .Spawn(std::make_shared<Plant>(x_pos, y_pos));
         }
       }
-    }
-
-    // Combine all local plants into the main vector
-    #pragma omp critical
-    {
-      for (auto &thread_local_plants : local_plants) {
-        data.food_entities_.insert(data.food_entities_.end(), thread_local_plants.begin(), thread_local_plants.end());
-      }
-    }
+    }, 1);
   }
 
 
@@ -69,8 +65,7 @@ void FoodManager::GenerateMoreFood(SimulationData &data, Environment &environmen
  * @param deltaTime Time that has passed since last update
  */
 void FoodManager::UpdateAllFood(SimulationData &data, double deltaTime){
-#pragma omp parallel for
-  for (auto food : data.food_entities_){
-      food->Update(deltaTime);
-  }
+  ThreadPool::Global().ParallelFor(0, data.food_entities_.size(), [&](int i) {
+      data.food_entities_[i]->Update(deltaTime);
+  });
 }
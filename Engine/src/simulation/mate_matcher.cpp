@@ -0,0 +1,159 @@
+#include "simulation/mate_matcher.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "core/scratch_arena.h"
+#include "core/settings.h"
+#include "core/thread_pool.h"
+
+namespace {
+
+/*!
+ * @brief Number of cells along one side of the map.
+ *
+ * @details Cells are at least as wide as the mating distance. The count is a
+ * multiple of 3, so the wrapped blocks of cells of the same colour class stay
+ * disjoint, or 1 when the map is too small for three cells.
+ */
+int Divisions(double extent, double distance) {
+  int cells = distance > 0 ? static_cast<int>(extent / distance) : 1;
+  return cells < 3 ? 1 : cells - cells % 3;
+}
+
+/*!
+ * @brief The distinct cells of a row or column next to a cell, itself
+ * included, wrapping around the map.
+ */
+ScratchVector<int> Neighbours(int cell, int cells) {
+  if (cells == 1) return {0};
+  return {(cell + cells - 1) % cells, cell, (cell + 1) % cells};
+}
+
+}  // namespace
+
+/*!
+ * @brief Pairs the living creatures waiting to reproduce.
+ *
+ * @details Each creature appears in at most one pair. Creatures left
+ * unmatched keep waiting and are tried again on the next call.
+ *
+ * @param creatures The creatures of the simulation.
+ *
+ * @return The pairs, in a deterministic order.
+ */
+std::vector<MatePair> MateMatcher::Match(
+    const std::vector<std::shared_ptr<Creature>>& creatures) {
+  const double kMapWidth = SETTINGS.environment.map_width;
+  const double kMapHeight = SETTINGS.environment.map_height;
+  const double kDistance = SETTINGS.compatibility.compatibility_distance;
+  columns_ = Divisions(kMapWidth, kDistance);
+  rows_ = Divisions(kMapHeight, kDistance);
+
+  cells_.resize(columns_ * rows_);
+  for (auto& cell : cells_) cell.clear();
+  cell_pairs_.resize(cells_.size());
+  matched_.assign(creatures.size(), 0);
+
+  for (int i = 0; i < creatures.size(); i++) {
+    const Creature& creature = *creatures[i];
+    if (creature.GetState() != Entity::Alive ||
+        !creature.WaitingToReproduce()) {
+      continue;
+    }
+    auto [x, y] = creature.GetCoordinates();
+    int column = std::clamp(static_cast<int>(x * columns_ / kMapWidth), 0,
+                            columns_ - 1);
+    int row =
+        std::clamp(static_cast<int>(y * rows_ / kMapHeight), 0, rows_ - 1);
+    cells_[row * columns_ + column].push_back(i);
+  }
+
+  std::vector<MatePair> pairs;
+  ScratchVector<int> colour_cells;
+  const int kColumnColours = std::min(columns_, 3);
+  const int kRowColours = std::min(rows_, 3);
+  for (int row_colour = 0; row_colour < kRowColours; row_colour++) {
+    for (int column_colour = 0; column_colour < kColumnColours;
+         column_colour++) {
+      colour_cells.clear();
+      for (int row = row_colour; row < rows_; row += 3) {
+        for (int column = column_colour; column < columns_; column += 3) {
+          if (!cells_[row * columns_ + column].empty()) {
+            colour_cells.push_back(row * columns_ + column);
+          }
+        }
+      }
+      ThreadPool::Global().ParallelFor(0, colour_cells.size(), [&](int i) {
+        int cell = colour_cells[i];
+        cell_pairs_[cell].clear();
+        MatchCell(creatures, cell % columns_, cell / columns_,
+                  cell_pairs_[cell]);
+      }, 1);
+      for (int cell : colour_cells) {
+        pairs.insert(pairs.end(), cell_pairs_[cell].begin(),
+                     cell_pairs_[cell].end());
+      }
+    }
+  }
+  return pairs;
+}
+
+/*!
+ * @brief Finds a mother for every father waiting in a cell.
+ *
+ * @details Only touches the creatures of the 3x3 block around the cell, which
+ * no other cell of its colour class reads or writes.
+ */
+void MateMatcher::MatchCell(
+    const std::vector<std::shared_ptr<Creature>>& creatures, int column,
+    int row, std::vector<MatePair>& pairs) {
+  const double kDistance = SETTINGS.compatibility.compatibility_distance;
+  const ScratchVector<int> rows = Neighbours(row, rows_);
+  const ScratchVector<int> columns = Neighbours(column, columns_);
+  // sized up front, the arena keeps every buffer a vector outgrows
+  std::size_t block_size = 0;
+  for (int neighbour_row : rows) {
+    for (int neighbour_column : columns) {
+      block_size += cells_[neighbour_row * columns_ + neighbour_column].size();
+    }
+  }
+  ScratchVector<int> block;
+  block.reserve(block_size);
+  for (int neighbour_row : rows) {
+    for (int neighbour_column : columns) {
+      const auto& cell = cells_[neighbour_row * columns_ + neighbour_column];
+      block.insert(block.end(), cell.begin(), cell.end());
+    }
+  }
+
+  // (other species, distance, index) of the mothers in range
+  ScratchVector<std::tuple<bool, double, int>> candidates;
+  candidates.reserve(block.size());
+  for (int father_index : cells_[row * columns_ + column]) {
+    if (matched_[father_index]) continue;
+    const auto& father = creatures[father_index];
+    if (!father->MaleReproductiveSystem::ReadyToProcreate()) continue;
+
+    candidates.clear();
+    for (int mother_index : block) {
+      if (mother_index == father_index || matched_[mother_index]) continue;
+      const auto& mother = creatures[mother_index];
+      if (!mother->FemaleReproductiveSystem::ReadyToProcreate()) continue;
+      double distance = father->GetDistance(mother);
+      if (distance >= kDistance) continue;
+      candidates.emplace_back(father->GetSpecies() != mother->GetSpecies(),
+                              distance, mother_index);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& [other_species, distance, mother_index] : candidates) {
+      if (father->Compatible(creatures[mother_index])) {
+        matched_[father_index] = 1;
+        matched_[mother_index] = 1;
+        pairs.push_back({father, creatures[mother_index]});
+        break;
+      }
+    }
+  }
+}
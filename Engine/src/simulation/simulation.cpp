@@ -2,6 +2,10 @@
 #include "simulation/simulation.h"
 #include <chrono>
 
+#include "core/scratch_arena.h"
+#include "core/settings.h"
+#include "neat/compatibility_cache.h"
+
 
 Simulation::Simulation(Environment& environment)
     : food_manager_(),
@@ -56,6 +60,15 @@ void Simulation::FixedUpdate(double deltaTime) {
     creature_manager_.UpdateAllCreatures(*data, environment, entity_grid_, deltaTime);
 #ifdef ENABLE_TIMING
     print_duration("UpdateAllCreatures");
+    std::cout << "Think skip rate: " << creature_manager_.GetThinkSkipRate()
+              << "\n";
+    std::cout << "Compatibility cache hit rate: "
+              << neat::CompatibilityCache::GetInstance().GetHitRate() << "\n";
+    if (SETTINGS.engine.validate_brain_precision) {
+      std::cout << "Brain drift: max "
+                << creature_manager_.GetBrainBatch().GetMaxDrift() << ", mean "
+                << creature_manager_.GetBrainBatch().GetMeanDrift() << "\n";
+    }
     #endif
 
     creature_manager_.ReproduceCreatures(*data, environment);
@@ -78,6 +91,12 @@ void Simulation::FixedUpdate(double deltaTime) {
     print_duration("UpdateAllFood");
     #endif
 
+    // single sync point for the structural changes of the tick
+    data->commands_.Apply(*data);
+#ifdef ENABLE_TIMING
+    print_duration("ApplyCommands");
+    #endif
+
     entity_grid_.UpdateGrid(*data_, environment, deltaTime);
 #ifdef ENABLE_TIMING
     print_duration("UpdateGrid");
@@ -94,6 +113,9 @@ void Simulation::FixedUpdate(double deltaTime) {
     print_duration("UpdateTimeAndStatistics");
     #endif
 
+    // the temporaries of the tick are dead, rewind the arenas of all threads
+    ScratchArena::ResetAll();
+
     //std::cout << "World time: " << data_->world_time_ << std::endl;
 }
 
@@ -101,6 +123,15 @@ DataAccessor<SimulationData> Simulation::GetSimulationData() {
   return DataAccessor<SimulationData>(*data_, data_sync_);
 }
 
+/*!
+ * @brief The creature manager, e.g. for its species. The simulation thread
+ * updates it under the data lock, so read it while holding the accessor of
+ * GetSimulationData.
+ */
+const CreatureManager& Simulation::GetCreatureManager() const {
+  return creature_manager_;
+}
+
 // Function to stop the simulation
 
 void Simulation::Stop() { is_running_ = false; }
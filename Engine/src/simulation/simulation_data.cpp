@@ -9,11 +9,29 @@
 #include <nlohmann/json.hpp>
 
 #include "core/collision_functions.h"
+#include "core/id_service.h"
 #include "entity/food.h"
 #include "core/settings.h"
 
 #include <QDebug>
 
+namespace {
+
+/*!
+ * @brief Keeps the ids of a loaded genome from being handed out again.
+ */
+void ObserveGenomeIds(const neat::Genome& genome) {
+  // neurons and links are sorted by id
+  if (!genome.GetNeurons().empty()) {
+    IdService::Observe(IdService::kNeuron, genome.GetNeurons().back().GetId());
+  }
+  if (!genome.GetLinks().empty()) {
+    IdService::Observe(IdService::kLink, genome.GetLinks().back().GetId());
+  }
+}
+
+}  // namespace
+
 /*!
  * @brief Retrieves the current environment of the simulation.
  *
@@ -165,7 +183,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
         egg_entry["y_coord"] = egg_item->Entity::GetCoordinates().second;
 
         egg_entry["genome"]["neurons"] = nlohmann::json::array();
-        auto egg_neurons = egg_item->GetGenome().GetNeurons();
+        const auto& egg_neurons = egg_item->GetGenome().GetNeurons();
         for (const auto& neuron : egg_neurons) {
             nlohmann::json neuron_entry;
             neuron_entry["id"] = neuron.GetId();
@@ -177,7 +195,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
         }
 
         egg_entry["genome"]["links"] = nlohmann::json::array();
-        auto egg_links = egg_item->GetGenome().GetLinks();
+        const auto& egg_links = egg_item->GetGenome().GetLinks();
         for (const auto& link : egg_links) {
             nlohmann::json link_entry;
             link_entry["id"] = link.GetId();
@@ -189,7 +207,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
             egg_entry["genome"]["links"] += link_entry;
         }
 
-        auto modules = egg_item->GetGenome().GetModules();
+        const auto& modules = egg_item->GetGenome().GetModules();
         egg_entry["genome"]["modules"] = nlohmann::json::array();
         for (const auto& module : modules) {
             nlohmann::json module_entry;
@@ -267,7 +285,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
         creature_entry["generation"] = creature_item->GetGeneration();
 
         creature_entry["genome"]["neurons"] = nlohmann::json::array();
-        auto creature_neurons = creature_item->GetGenome().GetNeurons();
+        const auto& creature_neurons = creature_item->GetGenome().GetNeurons();
         for (const auto& neuron : creature_neurons) {
             nlohmann::json neuron_entry;
             neuron_entry["id"] = neuron.GetId();
@@ -279,7 +297,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
         }
 
         creature_entry["genome"]["links"] = nlohmann::json::array();
-        auto creature_links = creature_item->GetGenome().GetLinks();
+        const auto& creature_links = creature_item->GetGenome().GetLinks();
         for (const auto& link : creature_links) {
             nlohmann::json link_entry;
             link_entry["id"] = link.GetId();
@@ -291,7 +309,7 @@ void SimulationData::WriteDataToFile(std::filesystem::path filename) {
             creature_entry["genome"]["links"] += link_entry;
         }
 
-        auto modules = creature_item->GetGenome().GetModules();
+        const auto& modules = creature_item->GetGenome().GetModules();
         creature_entry["genome"]["modules"] = nlohmann::json::array();
         for (const auto& module : modules) {
             nlohmann::json module_entry;
@@ -411,8 +429,9 @@ void SimulationData::RetrieveDataFromFile(std::filesystem::path simulationFilePa
               modules.emplace_back(module["first_input_index"], module["first_output_index"], module["input_neuron_ids"], module["output_neuron_ids"], module["module_id"], module["multiple"], module["type"]);
             }
             genome.SetModules(modules);
+            ObserveGenomeIds(genome);
 
-            std::shared_ptr<Egg> egg = std::make_shared<Egg>(GestatingEgg(genome, mutables, egg_item["generation"]), coords);
+            std::shared_ptr<Egg> egg = std::make_shared<Egg>(GestatingEgg(std::make_shared<const neat::Genome>(genome), mutables, egg_item["generation"]), coords);
             // egg->SetIncubationTime(egg_item["incubation time"]);
             egg->SetHealth(egg_item["health"]);
             egg->SetAge(egg_item["age"]);
@@ -469,6 +488,7 @@ void SimulationData::RetrieveDataFromFile(std::filesystem::path simulationFilePa
           modules.emplace_back(module["first_input_index"], module["first_output_index"], module["input_neuron_ids"], module["output_neuron_ids"], module["module_id"], module["multiple"], module["type"]);
         }
         genome.SetModules(modules);
+        ObserveGenomeIds(genome);
 
         std::shared_ptr<Creature> creature = std::make_shared<Creature>(genome, mutables);
         creature->SetCoordinates(coords.first, coords.second);
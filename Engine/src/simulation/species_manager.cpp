@@ -0,0 +1,116 @@
+#include "simulation/species_manager.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include "core/random.h"
+#include "core/settings.h"
+#include "neat/compatibility_cache.h"
+
+SpeciesManager::SpeciesManager()
+    : species_(),
+      next_species_id_(1),
+      last_refresh_(-std::numeric_limits<double>::infinity()) {}
+
+/*!
+ * @brief Assigns a species to a creature.
+ *
+ * @details The species are tried in order of foundation and the first one
+ * whose representative is compatible is taken. If none is, the creature
+ * becomes the representative of a new species.
+ *
+ * @param creature The creature to classify.
+ *
+ * @return The species label given to the creature.
+ */
+int SpeciesManager::Assign(Creature& creature) {
+  for (Species& species : species_) {
+    if (Compatible(species, creature)) {
+      species.size++;
+      creature.SetSpecies(species.id);
+      return species.id;
+    }
+  }
+  species_.push_back({next_species_id_++, creature.GetSharedGenome(),
+                      creature.GetGenomeHash(), creature.GetMutable(), 1});
+  creature.SetSpecies(species_.back().id);
+  return species_.back().id;
+}
+
+/*!
+ * @brief Recounts the species and picks new representatives, at most once
+ * per refresh interval.
+ *
+ * @details Creatures without a known species, e.g. loaded from a file, are
+ * assigned first. Representatives are drawn uniformly among the living
+ * members by reservoir sampling, so a refresh is a single pass over the
+ * creatures.
+ *
+ * @param data The simulation data holding the creatures.
+ */
+void SpeciesManager::Refresh(SimulationData& data) {
+  if (data.world_time_ >= last_refresh_ &&
+      data.world_time_ - last_refresh_ <
+          SETTINGS.compatibility.species_refresh_interval) {
+    return;
+  }
+  last_refresh_ = data.world_time_;
+
+  std::unordered_map<int, int> index;
+  for (int i = 0; i < species_.size(); i++) {
+    index[species_[i].id] = i;
+    species_[i].size = 0;
+  }
+  std::vector<std::shared_ptr<Creature>> unassigned;
+  for (const auto& creature : data.creatures_) {
+    auto it = index.find(creature->GetSpecies());
+    if (it == index.end()) {
+      unassigned.push_back(creature);
+      continue;
+    }
+    Species& species = species_[it->second];
+    species.size++;
+    if (Random::Int(1, species.size) == 1) {
+      species.genome = creature->GetSharedGenome();
+      species.genome_hash = creature->GetGenomeHash();
+      species.mutables = creature->GetMutable();
+    }
+  }
+
+  species_.erase(std::remove_if(species_.begin(), species_.end(),
+                                [](const Species& species) {
+                                  return species.size == 0;
+                                }),
+                 species_.end());
+  for (const auto& creature : unassigned) Assign(*creature);
+}
+
+/*!
+ * @brief Forgets every species.
+ */
+void SpeciesManager::Clear() {
+  species_.clear();
+  next_species_id_ = 1;
+  last_refresh_ = -std::numeric_limits<double>::infinity();
+}
+
+const std::vector<Species>& SpeciesManager::GetSpecies() const {
+  return species_;
+}
+
+int SpeciesManager::GetSpeciesCount() const { return species_.size(); }
+
+/*!
+ * @brief Checks a creature against the representative of a species.
+ */
+bool SpeciesManager::Compatible(const Species& species,
+                                const Creature& creature) const {
+  double brain_distance = neat::CompatibilityCache::GetInstance().Distance(
+      species.genome, species.genome_hash, creature.GetSharedGenome(),
+      creature.GetGenomeHash());
+  double mutable_distance =
+      species.mutables.CompatibilityBetweenMutables(creature.GetMutable());
+  return brain_distance + mutable_distance <
+         SETTINGS.compatibility.compatibility_threshold;
+}
@@ -653,6 +653,39 @@ TEST(SimulationDataTest, CorrectEntityPlacementInGrid) {
   EXPECT_NE(entity_grid.GetGrid()[foodGridX][foodGridY].empty(), true);
 }
 
+/*!
+ * @brief Tests that commands recorded in a parallel loop are applied in key
+ * order.
+ *
+ * @details Plants spawned by the iterations of a parallel loop must appear in
+ * iteration order whatever the thread schedule, and a transform must remove
+ * the entity and leave its remains.
+ */
+TEST(SimulationDataTest, CommandBuffersApplyInKeyOrder) {
+  Environment environment;
+  SimulationData simData(environment);
+  auto creature = std::make_shared<Creature>(neat::Genome(1, 1), Mutable());
+
+  simData.commands_.BeginPhase();
+  #pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < 100; i++) {
+    simData.commands_.Local(i).Spawn(std::make_shared<Plant>(i, 1.0));
+  }
+  simData.commands_.BeginPhase();
+  simData.commands_.Local(0).Transform(
+      creature, std::make_shared<Meat>(500.0, 1.0, 1.0));
+  EXPECT_FALSE(simData.commands_.Empty());
+  simData.commands_.Apply(simData);
+
+  EXPECT_TRUE(simData.commands_.Empty());
+  ASSERT_EQ(simData.food_entities_.size(), 101);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_DOUBLE_EQ(simData.food_entities_[i]->GetCoordinates().first, i);
+  }
+  EXPECT_DOUBLE_EQ(simData.food_entities_[100]->GetCoordinates().first, 500.0);
+  EXPECT_EQ(creature->GetState(), Entity::Dead);
+}
+
 /*!
  * @brief Tests for calculating neighboring cells in a grid.
  *
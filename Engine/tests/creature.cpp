@@ -1,8 +1,13 @@
 #include <entity/creature/creature.h>
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include "core/geometry_primitives.h"
 #include "core/settings.h"
+#include "entity/creature/metabolism_batch.h"
+#include "simulation/mate_matcher.h"
+#include "simulation/species_manager.h"
 
 /*!
  * @file creature.cpp
@@ -355,3 +360,318 @@ TEST(CreatureTests, EmptinessPercent) {
 
   ASSERT_LT(creature.GetStomachFullness(), 100.0);
 }
+
+/*!
+ * @brief Tests that the SpeciesManager groups compatible creatures and keeps
+ * its counts current on refresh.
+ *
+ * @details Two creatures sharing a genome join one species. After a refresh
+ * the count follows the living creatures, and a creature without a known
+ * species is assigned.
+ */
+TEST(CreatureTests, SpeciesManagerAssignsAgainstRepresentatives) {
+  auto genome = std::make_shared<const neat::Genome>(4, 4);
+  Mutable mutables;
+  auto first = std::make_shared<Creature>(genome, mutables);
+  auto second = std::make_shared<Creature>(genome, mutables);
+  auto third = std::make_shared<Creature>(genome, mutables);
+
+  SpeciesManager species_manager;
+  int species_id = species_manager.Assign(*first);
+  EXPECT_NE(species_id, 0);
+  EXPECT_EQ(species_manager.Assign(*second), species_id);
+  ASSERT_EQ(species_manager.GetSpeciesCount(), 1);
+  EXPECT_EQ(species_manager.GetSpecies()[0].size, 2);
+
+  Environment environment;
+  SimulationData data(environment);
+  data.creatures_ = {second, third};
+  species_manager.Refresh(data);
+  EXPECT_EQ(third->GetSpecies(), species_id);
+  ASSERT_EQ(species_manager.GetSpeciesCount(), 1);
+  EXPECT_EQ(species_manager.GetSpecies()[0].size, 2);
+}
+
+/*!
+ * @brief Tests that the MateMatcher pairs waiting creatures within the mating
+ * distance only, each at most once.
+ *
+ * @details Two ready creatures close to each other across the map edge form
+ * one pair, a third one far from both is left waiting.
+ */
+TEST(CreatureTests, MateMatcherPairsNearbyCreatures) {
+  auto genome = std::make_shared<const neat::Genome>(4, 4);
+  Mutable mutables;
+  std::vector<std::shared_ptr<Creature>> creatures;
+  for (double x : {5.0, SETTINGS.environment.map_width - 5.0,
+                   SETTINGS.environment.map_width / 2}) {
+    auto creature = std::make_shared<Creature>(genome, mutables);
+    creature->SetCoordinates(x, 100.0);
+    creature->SetAge(creature->MaleReproductiveSystem::GetMaturityAge() + 10);
+    creature->SetWaitingToReproduce(true);
+    creatures.push_back(creature);
+  }
+
+  MateMatcher mate_matcher;
+  std::vector<MatePair> pairs = mate_matcher.Match(creatures);
+  ASSERT_EQ(pairs.size(), 1);
+  EXPECT_NE(pairs[0].father, pairs[0].mother);
+  EXPECT_NE(pairs[0].father, creatures[2]);
+  EXPECT_NE(pairs[0].mother, creatures[2]);
+}
+
+/*!
+ * @brief Tests that the BindingPlan wires the brain modules of a genome and
+ * drops the bindings outside the network.
+ */
+TEST(CreatureTests, BindingPlanCompilesModules) {
+  neat::Genome genome(12, 4);
+  genome.SetModules({BrainModule(12, 0, {0, 0, 0, 0, 0}, {}, 3, true, 0),
+                     BrainModule(17, 4, {0}, {0}, 2, true, 7),
+                     BrainModule(100, 0, {0, 0, 0}, {}, 1, false, 0)});
+  BindingPlan plan(genome, 18, 5);
+
+  const auto& sensors = plan.GetSensors();
+  ASSERT_EQ(sensors.size(), 10);
+  EXPECT_EQ(sensors[0].kind, SensorBinding::kBias);
+  EXPECT_EQ(sensors[7].kind, SensorBinding::kVision);
+  EXPECT_EQ(sensors[7].source, 0);
+  EXPECT_EQ(sensors[7].destination, 7);
+  EXPECT_EQ(sensors[8].kind, SensorBinding::kVision);
+  EXPECT_EQ(sensors[8].source, 1);
+  EXPECT_EQ(sensors[8].destination, 12);
+  EXPECT_EQ(sensors[9].kind, SensorBinding::kPheromone);
+  EXPECT_EQ(sensors[9].source, 7);
+  EXPECT_EQ(sensors[9].destination, 17);
+
+  const auto& actuators = plan.GetActuators();
+  ASSERT_EQ(actuators.size(), 5);
+  EXPECT_EQ(actuators[3].kind, ActuatorBinding::kAttack);
+  EXPECT_EQ(actuators[4].kind, ActuatorBinding::kPheromoneEmission);
+  EXPECT_EQ(actuators[4].source, 4);
+  EXPECT_EQ(actuators[4].target, 7);
+}
+
+/*!
+ * @brief Tests that the stencil vision query returns the true nearest
+ * entities in the cone, across the map edges.
+ *
+ * @details Compares against a brute force scan of every entity with
+ * IsInVisionCone, for random positions and orientations.
+ */
+TEST(CreatureTests, VisionQueryReturnsNearestInCone) {
+  const double kCellSize = 10.0, kMapSize = 200.0;
+  const int kCells = kMapSize / kCellSize;
+  std::mt19937 engine(5);
+  std::uniform_real_distribution<double> coordinate(0, kMapSize);
+  std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+
+  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> grid(
+      kCells, std::vector<std::vector<std::shared_ptr<Entity>>>(kCells));
+  std::vector<std::shared_ptr<Entity>> entities;
+  for (int i = 0; i < 300; i++) {
+    auto meat = std::make_shared<Meat>(coordinate(engine), coordinate(engine),
+                                       1 + i % 5);
+    grid[meat->GetCoordinates().first / kCellSize]
+        [meat->GetCoordinates().second / kCellSize]
+            .push_back(meat);
+    entities.push_back(meat);
+  }
+
+  neat::Genome genome(12, 4);
+  genome.SetModules({BrainModule(12, 0, {0, 0, 0, 0, 0}, {}, 3, true, 0),
+                     BrainModule(17, 0, {0, 0, 0, 0, 0}, {}, 3, true, 0)});
+  Mutable mutables;
+  Creature creature(genome, mutables);
+  creature.SetVision(45.0, M_PI / 2);
+
+  for (int query = 0; query < 50; query++) {
+    creature.SetCoordinates(coordinate(engine), coordinate(engine));
+    creature.SetOrientation(angle(engine));
+
+    std::vector<double> expected;
+    for (const auto& entity : entities) {
+      if (creature.IsInVisionCone(entity, kMapSize, kMapSize)) {
+        expected.push_back(Point(entity->GetCoordinates())
+                               .dist(creature.GetCoordinates(), kMapSize,
+                                     kMapSize));
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(3, -1);
+
+    auto found =
+        creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize, kMapSize);
+    ASSERT_EQ(found.size(), 3);
+    for (int i = 0; i < 3; i++) {
+      double distance =
+          found[i] ? Point(found[i]->GetCoordinates())
+                         .dist(creature.GetCoordinates(), kMapSize, kMapSize)
+                   : -1;
+      EXPECT_DOUBLE_EQ(distance, expected[i]) << "query " << query;
+    }
+  }
+}
+
+/*!
+ * @brief Tests that repeated vision queries reuse the previous result and
+ * still notice entities arriving in or leaving the scanned cells.
+ */
+TEST(CreatureTests, VisionCacheTracksOccupancyChanges) {
+  const double kCellSize = 10.0, kMapSize = 200.0;
+  const int kCells = kMapSize / kCellSize;
+  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> grid(
+      kCells, std::vector<std::vector<std::shared_ptr<Entity>>>(kCells));
+  auto place = [&](double x, double y) {
+    auto meat = std::make_shared<Meat>(x, y, 1.0);
+    grid[x / kCellSize][y / kCellSize].push_back(meat);
+    return meat;
+  };
+
+  neat::Genome genome(12, 4);
+  Mutable mutables;
+  Creature creature(genome, mutables);
+  creature.SetCoordinates(100.0, 100.0);
+  creature.SetOrientation(0.0);
+  creature.SetVision(50.0, M_PI / 2);
+
+  auto far = place(140.0, 101.0);
+  auto first = creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize, kMapSize);
+  EXPECT_EQ(first[0], far);
+  EXPECT_EQ(creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize,
+                                               kMapSize)[0],
+            far);
+
+  auto near = place(115.0, 99.0);
+  EXPECT_EQ(creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize,
+                                               kMapSize)[0],
+            near);
+
+  near->SetState(Entity::Dead);
+  grid[11][9].clear();
+  EXPECT_EQ(creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize,
+                                               kMapSize)[0],
+            far);
+
+  // same occupancy, other entity
+  grid[14][10].clear();
+  auto swapped = place(140.0, 100.0);
+  EXPECT_EQ(creature.GetClosestEntitiesInSight(grid, kCellSize, kMapSize,
+                                               kMapSize)[0],
+            swapped);
+
+  // the cache does not keep what it saw alive
+  grid[14][10].clear();
+  EXPECT_EQ(swapped.use_count(), 1);
+}
+
+TEST(CreatureTests, RayVisionStopsAtFirstHit) {
+  const double kCellSize = 10.0, kMapSize = 200.0;
+  const int kCells = kMapSize / kCellSize;
+  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> grid(
+      kCells, std::vector<std::vector<std::shared_ptr<Entity>>>(kCells));
+  auto place = [&](std::shared_ptr<Entity> entity) {
+    auto [x, y] = entity->GetCoordinates();
+    grid[x / kCellSize][y / kCellSize].push_back(entity);
+  };
+
+  neat::Genome genome(12, 4);
+  Mutable mutables;
+  Creature creature(genome, mutables);
+  creature.SetCoordinates(195.0, 100.0);
+  creature.SetOrientation(0.0);
+  creature.SetVision(50.0, 0.01);
+
+  double out[3];
+  creature.CastRays(grid, kCellSize, kMapSize, kMapSize, 1, out);
+  EXPECT_DOUBLE_EQ(out[0], 50.0);
+  EXPECT_EQ(out[1], VisionSystem::kNothing);
+
+  // ahead across the map border, behind a plant further away
+  place(std::make_shared<Plant>(35.0, 100.0, 2.0));
+  place(std::make_shared<Meat>(20.0, 100.0, 2.0));
+  place(std::make_shared<Meat>(180.0, 100.0, 2.0));
+  creature.CastRays(grid, kCellSize, kMapSize, kMapSize, 1, out);
+  EXPECT_NEAR(out[0], 23.0, 1e-9);
+  EXPECT_EQ(out[1], VisionSystem::kMeat);
+}
+
+TEST(CreatureTests, UnchangedInputsReuseBrainOutputs) {
+  const double kCellSize = 10.0, kMapSize = 200.0;
+  const int kCells = kMapSize / kCellSize;
+  std::vector<std::vector<std::vector<std::shared_ptr<Entity>>>> grid(
+      kCells, std::vector<std::vector<std::shared_ptr<Entity>>>(kCells));
+
+  neat::Genome genome(12, 4);
+  Mutable mutables;
+  Creature creature(genome, mutables);
+  creature.SetCoordinates(100.0, 100.0);
+  auto sense = [&] {
+    while (!creature.Sense(grid, kCellSize, kMapSize, kMapSize)) {}
+  };
+
+  const double tolerance = SETTINGS.engine.think_skip_tolerance;
+  SETTINGS.engine.think_skip_tolerance = 0.01;
+  neat::NeuralNetworkBatch batch;
+  sense();
+  EXPECT_TRUE(creature.QueueThink(batch));
+  batch.Activate();
+
+  // nothing in sight and the same energy
+  sense();
+  EXPECT_FALSE(creature.QueueThink(batch));
+
+  creature.SetEnergy(creature.GetEnergy() * 2);
+  sense();
+  EXPECT_TRUE(creature.QueueThink(batch));
+
+  SETTINGS.engine.think_skip_tolerance = 0;
+  sense();
+  EXPECT_TRUE(creature.QueueThink(batch));
+  SETTINGS.engine.think_skip_tolerance = tolerance;
+}
+
+TEST(CreatureTests, MetabolismBatchMatchesScalarUpdate) {
+  neat::Genome genome(12, 4);
+  Mutable mutables;
+  std::vector<std::shared_ptr<Creature>> batched, scalar;
+  for (int i = 0; i < 4; i++) {
+    auto creature = std::make_shared<Creature>(genome, mutables);
+    creature->SetAcceleration(0.5 * i);
+    creature->SetRotationalAcceleration(-0.25 * i);
+    creature->SetStomachFullness(creature->GetStomachCapacity() / (i + 1));
+    creature->SetAcid(creature->GetStomachCapacity() / 2);
+    batched.push_back(creature);
+  }
+  batched[1]->SetEnergy(batched[1]->GetMaxEnergy());
+  // starves to death this step
+  batched[2]->SetEnergy(-1000);
+  batched[2]->SetHealth(1);
+  batched[3]->Dies();
+  for (auto& creature : batched) {
+    scalar.push_back(std::make_shared<Creature>(*creature));
+  }
+
+  const double kDeltaTime = 0.1;
+  MetabolismBatch batch;
+  for (auto& creature : batched) batch.Add(*creature);
+  batch.Step(kDeltaTime);
+
+  for (int i = 0; i < batched.size(); i++) {
+    scalar[i]->UpdateMetabolism(kDeltaTime);
+    EXPECT_NEAR(batched[i]->GetEnergy(), scalar[i]->GetEnergy(), 1e-9);
+    EXPECT_NEAR(batched[i]->GetHealth(), scalar[i]->GetHealth(), 1e-9);
+    EXPECT_NEAR(batched[i]->GetSize(), scalar[i]->GetSize(), 1e-12);
+    EXPECT_NEAR(batched[i]->GetAge(), scalar[i]->GetAge(), 1e-12);
+    EXPECT_NEAR(batched[i]->GetAcid(), scalar[i]->GetAcid(), 1e-9);
+    EXPECT_NEAR(batched[i]->GetStomachFullness(),
+                scalar[i]->GetStomachFullness(), 1e-9);
+    EXPECT_NEAR(batched[i]->GetStomachCapacity(),
+                scalar[i]->GetStomachCapacity(), 1e-9);
+    EXPECT_EQ(batched[i]->GetMatingDesire(), scalar[i]->GetMatingDesire());
+    EXPECT_EQ(batched[i]->GetState(), scalar[i]->GetState());
+    EXPECT_EQ(batch.GetDeaths()[i], scalar[i]->GetState() == Entity::Dead);
+  }
+  EXPECT_TRUE(batch.GetDeaths()[2]);
+  EXPECT_TRUE(batch.GetDeaths()[3]);
+}
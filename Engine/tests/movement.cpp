@@ -1,4 +1,5 @@
 #include "entity/movable_entity.h"
+#include "entity/locomotion_batch.h"
 #include "core/settings.h"
 #include <gtest/gtest.h>
 #include "math.h"
@@ -82,3 +83,85 @@ TEST(EffectiveAngle, AlignedAcceleration){
 }
 
 
+
+TEST(Locomotion, BatchMatchesScalarUpdate) {
+    const double kMapSize = 100.0, kDeltaTime = 0.05;
+    std::vector<MovableEntity> scalar(3), batched(3);
+    for (int i = 0; i < 3; i++) {
+        for (MovableEntity* entity : {&scalar[i], &batched[i]}) {
+            entity->SetSize(2 + i);
+            entity->SetCoordinates(98.0 - 40 * i, 1.0 + 30 * i, kMapSize, kMapSize);
+            entity->SetOrientation(0.3 - i);
+            entity->SetVelocity(5 + 10 * i);
+            entity->SetVelocityAngle(0.2 * i - 0.1);
+            entity->SetAcceleration(20.0);
+            entity->SetAccelerationAngle(1.0 - i);
+            entity->SetRotationalAcceleration(0.5 * i);
+        }
+    }
+
+    // one step in the polar model: the velocity moves by the effective
+    // acceleration, both relative to the orientation
+    const MovableEntity& first = scalar[0];
+    double expected_x = first.GetVelocity() * cos(first.GetVelocityAngle()) +
+                        first.GetEffectiveForwardAcceleration() * kDeltaTime *
+                            cos(first.GetEffectiveAccelerationAngle());
+    double expected_y = first.GetVelocity() * sin(first.GetVelocityAngle()) +
+                        first.GetEffectiveForwardAcceleration() * kDeltaTime *
+                            sin(first.GetEffectiveAccelerationAngle());
+
+    LocomotionBatch batch;
+    for (int step = 0; step < 20; step++) {
+        batch.Clear();
+        for (int i = 0; i < 3; i++) {
+            scalar[i].UpdateVelocities(kDeltaTime);
+            scalar[i].Move(kDeltaTime, kMapSize, kMapSize);
+            scalar[i].Rotate(kDeltaTime);
+            batch.Add(batched[i]);
+        }
+        batch.Step(kDeltaTime, kMapSize, kMapSize);
+        if (step == 0) {
+            ASSERT_NEAR(batched[0].GetVelocity() * cos(batched[0].GetVelocityAngle()), expected_x, 1e-9);
+            ASSERT_NEAR(batched[0].GetVelocity() * sin(batched[0].GetVelocityAngle()), expected_y, 1e-9);
+        }
+        for (int i = 0; i < 3; i++) {
+            ASSERT_NEAR(batched[i].GetCoordinates().first, scalar[i].GetCoordinates().first, 1e-9);
+            ASSERT_NEAR(batched[i].GetCoordinates().second, scalar[i].GetCoordinates().second, 1e-9);
+            ASSERT_NEAR(batched[i].GetOrientation(), scalar[i].GetOrientation(), 1e-9);
+            ASSERT_NEAR(batched[i].GetVelocity(), scalar[i].GetVelocity(), 1e-9);
+            ASSERT_NEAR(batched[i].GetVelocityAngle(), scalar[i].GetVelocityAngle(), 1e-9);
+            ASSERT_NEAR(batched[i].GetRotationalVelocity(), scalar[i].GetRotationalVelocity(), 1e-9);
+        }
+    }
+    // the first entity crossed the right border
+    EXPECT_LT(batched[0].GetCoordinates().first, 50.0);
+}
+
+TEST(Locomotion, IntegrateWaitsForSwap) {
+    const double kMapSize = 100.0, kDeltaTime = 0.05;
+    MovableEntity scalar, batched;
+    for (MovableEntity* entity : {&scalar, &batched}) {
+        entity->SetSize(2);
+        entity->SetCoordinates(50.0, 50.0, kMapSize, kMapSize);
+        entity->SetVelocity(5);
+        entity->SetAcceleration(20.0);
+        entity->SetRotationalAcceleration(0.5);
+    }
+
+    LocomotionBatch batch;
+    batch.Add(batched);
+    batch.Integrate(kDeltaTime, kMapSize, kMapSize);
+    // the last state stays readable until the swap
+    ASSERT_EQ(batched.GetCoordinates(), std::make_pair(50.0, 50.0));
+    ASSERT_EQ(batched.GetOrientation(), scalar.GetOrientation());
+    ASSERT_EQ(batched.GetVelocity(), scalar.GetVelocity());
+
+    batch.Swap();
+    scalar.UpdateVelocities(kDeltaTime);
+    scalar.Move(kDeltaTime, kMapSize, kMapSize);
+    scalar.Rotate(kDeltaTime);
+    ASSERT_NEAR(batched.GetCoordinates().first, scalar.GetCoordinates().first, 1e-9);
+    ASSERT_NEAR(batched.GetCoordinates().second, scalar.GetCoordinates().second, 1e-9);
+    ASSERT_NEAR(batched.GetOrientation(), scalar.GetOrientation(), 1e-9);
+    ASSERT_NEAR(batched.GetVelocity(), scalar.GetVelocity(), 1e-9);
+}
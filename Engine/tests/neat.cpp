@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/id_service.h"
+#include "core/settings.h"
+#include "neat/compatibility_cache.h"
 #include "neat/neural_network.h"
+#include "neat/neural_network_batch.h"
+#include "neat/network_cache.h"
 
 /*!
  * @file neat.cpp
@@ -168,7 +179,7 @@ TEST(NeatTests, DisableLink) {
   Genome genome(3, 2);
   genome.AddLink(Link(1, 2, 0.5));
   genome.AddLink(Link(2, 3, 0.7));
-  int id = genome.GetLinks().back().GetId();
+  std::int64_t id = genome.GetLinks().back().GetId();
   genome.DisableLink(id);
 
   auto links = genome.GetLinks();
@@ -214,7 +225,7 @@ TEST(NeatTests, EnableLink) {
   Genome genome(3, 2);
   genome.AddLink(Link(1, 2, 0.5));
   genome.AddLink(Link(2, 3, 0.7));
-  int id = genome.GetLinks().back().GetId();
+  std::int64_t id = genome.GetLinks().back().GetId();
   genome.DisableLink(id);
   genome.EnableLink(id);
 
@@ -247,7 +258,7 @@ TEST(NeatTests, RemoveNeuron) {
   genome.AddNeuron(neuron3);
   genome.AddLink(Link(neuron1.GetId(), neuron2.GetId(), 0.7));
   genome.AddLink(Link(neuron2.GetId(), neuron3.GetId(), 0.4));
-  int id = neuron1.GetId();
+  std::int64_t id = neuron1.GetId();
   genome.RemoveNeuron(id);
 
   const auto& neurons = genome.GetNeurons();
@@ -474,6 +485,218 @@ TEST(NeatTests, MutateAddLink) {
   EXPECT_TRUE(cycle);
 }
 
+/*!
+ * @brief Tests that links added out of order are kept sorted by id and that
+ * the merge-based compatibility finds the shared links.
+ */
+TEST(NeatTests, GenomeKeepsLinksSorted) {
+  Genome genome(2, 1);
+  std::vector<Neuron> neurons = genome.GetNeurons();
+  std::int64_t base = neurons.back().GetId() * 10;
+  genome.AddLink(Link(base + 3, neurons[0].GetId(), neurons[2].GetId(), 0.5,
+                      true, false));
+  genome.AddLink(Link(base + 1, neurons[1].GetId(), neurons[2].GetId(), 0.5,
+                      true, false));
+  genome.AddLink(Link(base + 2, neurons[0].GetId(), neurons[2].GetId(), 0.5,
+                      true, false));
+  const std::vector<Link>& links = genome.GetLinks();
+  ASSERT_EQ(links.size(), 3);
+  EXPECT_EQ(links[0].GetId(), base + 1);
+  EXPECT_EQ(links[1].GetId(), base + 2);
+  EXPECT_EQ(links[2].GetId(), base + 3);
+
+  EXPECT_DOUBLE_EQ(genome.CompatibilityBetweenGenomes(genome), 0.0);
+  Genome other = genome;
+  other.RemoveLink(base + 2);
+  EXPECT_DOUBLE_EQ(genome.CompatibilityBetweenGenomes(other),
+                   other.CompatibilityBetweenGenomes(genome));
+  EXPECT_GT(genome.CompatibilityBetweenGenomes(other), 0.0);
+}
+
+/*!
+ * @brief Tests that neurons created on several threads get distinct ids and
+ * that observed ids are never handed out again.
+ */
+TEST(NeatTests, NeuronIdsUniqueAcrossThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 1000;
+  std::vector<std::vector<std::int64_t>> ids(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&ids, t]() {
+      for (int i = 0; i < kPerThread; i++) {
+        ids[t].push_back(Neuron(NeuronType::kHidden, 0.0).GetId());
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  std::unordered_set<std::int64_t> unique;
+  for (const std::vector<std::int64_t>& thread_ids : ids) {
+    unique.insert(thread_ids.begin(), thread_ids.end());
+  }
+  EXPECT_EQ(unique.size(), kThreads * kPerThread);
+
+  std::int64_t loaded = Neuron(NeuronType::kHidden, 0.0).GetId() + 10;
+  IdService::Observe(IdService::kNeuron, loaded);
+  EXPECT_GT(Neuron(NeuronType::kHidden, 0.0).GetId(), loaded);
+}
+
+/*!
+ * @brief Tests that the ids of two mutations activating the largest module
+ * fit the budget given by MaxNeuronsPerMutation, however many vision rays.
+ */
+TEST(NeatTests, MutationIdsFitTheirBudget) {
+  const int vision_rays = SETTINGS.environment.vision_rays;
+  const double module_rate = SETTINGS.neat.module_activation_mutation_rate;
+  SETTINGS.environment.vision_rays = 30;
+  SETTINGS.neat.module_activation_mutation_rate = 1;
+
+  Genome genome(3, 2);
+  genome.AddLink(Link(genome.GetNeurons()[0].GetId(),
+                      genome.GetNeurons()[3].GetId(), 1.0));
+  const std::int64_t last_parent_id = genome.GetNeurons().back().GetId();
+  const int budget = genome.MaxNeuronsPerMutation();
+  EXPECT_EQ(budget, 1 + 3 * 30);
+  const IdService::Batch batch = IdService::ReserveBatch(
+      1, {0, 2 * budget, 2 * Genome::kMaxLinksPerMutation});
+  {
+    IdService::ScopedJob job(batch, 0);
+    genome.Mutate();
+    genome.Mutate();
+  }
+  SETTINGS.environment.vision_rays = vision_rays;
+  SETTINGS.neat.module_activation_mutation_rate = module_rate;
+
+  const std::int64_t first = batch.first[IdService::kNeuron];
+  int created = 0;
+  for (const Neuron& neuron : genome.GetNeurons()) {
+    if (neuron.GetId() <= last_parent_id) continue;
+    created++;
+    EXPECT_GE(neuron.GetId(), first);
+    EXPECT_LT(neuron.GetId(), first + 2 * budget);
+  }
+  EXPECT_GT(created, 0);
+  for (const Link& link : genome.GetLinks()) {
+    if (link.GetId() < batch.first[IdService::kLink]) continue;
+    EXPECT_LT(link.GetId(),
+              batch.first[IdService::kLink] + 2 * Genome::kMaxLinksPerMutation);
+  }
+}
+
+/*!
+ * @brief Tests that neuron and link ids past the 32-bit range are kept whole.
+ */
+TEST(NeatTests, IdsPastThirtyTwoBits) {
+  const std::int64_t loaded = std::int64_t{1} << 32;
+  IdService::Observe(IdService::kNeuron, loaded);
+  IdService::Observe(IdService::kLink, loaded);
+  Neuron in(NeuronType::kInput, 0.0);
+  Neuron out(NeuronType::kOutput, 0.0);
+  Link link(in.GetId(), out.GetId(), 1.0);
+  EXPECT_GT(in.GetId(), loaded);
+  EXPECT_GT(out.GetId(), in.GetId());
+  EXPECT_GT(link.GetId(), loaded);
+  EXPECT_EQ(link.GetInId(), in.GetId());
+  EXPECT_EQ(link.GetOutId(), out.GetId());
+
+  Genome genome(0, 0);
+  genome.AddNeuron(in);
+  genome.AddNeuron(out);
+  genome.AddLink(link);
+  EXPECT_TRUE(genome.HasLink(in.GetId(), out.GetId()));
+  NeuralNetwork network(genome);
+  EXPECT_EQ(network.Activate({1.0}).size(), 1);
+}
+
+/*!
+ * @brief Tests that the jobs of an id batch get the ids of their index,
+ * whichever thread runs them and in whatever order.
+ */
+TEST(NeatTests, BatchIdsFollowTheJob) {
+  constexpr int kJobs = 4;
+  constexpr int kPerJob = 3;
+  const IdService::Batch batch =
+      IdService::ReserveBatch(kJobs, {0, kPerJob, 0});
+  std::vector<std::vector<std::int64_t>> ids(kJobs);
+  std::vector<std::thread> threads;
+  for (int job = kJobs - 1; job >= 0; job--) {
+    threads.emplace_back([&ids, &batch, job]() {
+      IdService::ScopedJob scope(batch, job);
+      for (int i = 0; i < kPerJob; i++) {
+        ids[job].push_back(Neuron(NeuronType::kHidden, 0.0).GetId());
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  for (int job = 0; job < kJobs; job++) {
+    for (int i = 0; i < kPerJob; i++) {
+      EXPECT_EQ(ids[job][i],
+                batch.first[IdService::kNeuron] + job * kPerJob + i);
+    }
+  }
+  const std::int64_t outside = Neuron(NeuronType::kHidden, 0.0).GetId();
+  EXPECT_TRUE(outside < batch.first[IdService::kNeuron] ||
+              outside >= batch.first[IdService::kNeuron] + kJobs * kPerJob);
+}
+
+/*!
+ * @brief Tests the incremental cycle check of a Genome.
+ *
+ * @details Links are added against the creation order of the neurons, so the
+ * topological order has to be repaired. Random mutations are then checked
+ * with an independent topological sort of the non-cyclic links.
+ */
+TEST(NeatTests, GenomeDetectsCyclesIncrementally) {
+  Genome genome(1, 1);
+  std::int64_t in = genome.GetNeurons()[0].GetId();
+  std::int64_t out = genome.GetNeurons()[1].GetId();
+  Neuron first(NeuronType::kHidden, 0.0);
+  Neuron second(NeuronType::kHidden, 0.0);
+  genome.AddNeuron(first);
+  genome.AddNeuron(second);
+  genome.AddLink(Link(second.GetId(), first.GetId(), 1.0));
+  genome.AddLink(Link(first.GetId(), out, 1.0));
+  genome.AddLink(Link(in, second.GetId(), 1.0));
+
+  EXPECT_TRUE(genome.CreatesCycle(first.GetId(), second.GetId()));
+  EXPECT_TRUE(genome.CreatesCycle(out, in));
+  EXPECT_TRUE(genome.CreatesCycle(first.GetId(), first.GetId()));
+  EXPECT_FALSE(genome.CreatesCycle(in, out));
+  EXPECT_FALSE(genome.CreatesCycle(second.GetId(), out));
+  EXPECT_TRUE(genome.HasLink(first.GetId(), second.GetId()));
+  EXPECT_FALSE(genome.HasLink(in, out));
+
+  Genome mutated(3, 2);
+  for (int i = 0; i < 300; i++) {
+    mutated.Mutate();
+    mutated.MutateAddLink();
+  }
+  std::unordered_map<std::int64_t, int> in_degree;
+  std::unordered_map<std::int64_t, std::vector<std::int64_t>> successors;
+  for (const Neuron& neuron : mutated.GetNeurons()) in_degree[neuron.GetId()];
+  for (const Link& link : mutated.GetLinks()) {
+    if (link.IsCyclic()) continue;
+    in_degree[link.GetOutId()]++;
+    successors[link.GetInId()].push_back(link.GetOutId());
+  }
+  std::vector<std::int64_t> ready;
+  for (const auto& [id, degree] : in_degree) {
+    if (degree == 0) ready.push_back(id);
+  }
+  int sorted = 0;
+  while (!ready.empty()) {
+    std::int64_t id = ready.back();
+    ready.pop_back();
+    sorted++;
+    for (std::int64_t successor : successors[id]) {
+      if (--in_degree[successor] == 0) ready.push_back(successor);
+    }
+  }
+  EXPECT_EQ(sorted, mutated.GetNeurons().size());
+}
+
 /*!
  * @brief Tests generating layers of neurons from a Genome.
  *
@@ -506,6 +729,47 @@ TEST(NeatTests, GetLayers) {
   }
 }
 
+/*!
+ * @brief Tests that network compilation prunes disabled links and dead ends.
+ *
+ * @details A hidden neuron without a path to an output is dropped, a disabled
+ * link does not contribute, and two hidden neurons linked in a cycle that is
+ * not marked as cyclic still compile instead of stalling the layering.
+ */
+TEST(NeatTests, CompileNetworkPrunesAndTerminates) {
+  Genome genome(1, 1);
+  std::int64_t in = genome.GetNeurons()[0].GetId();
+  std::int64_t out = genome.GetNeurons()[1].GetId();
+  Neuron dead_end(NeuronType::kHidden, 0.0);
+  Neuron a(NeuronType::kHidden, 0.0);
+  Neuron b(NeuronType::kHidden, 0.0);
+  genome.AddNeuron(dead_end);
+  genome.AddNeuron(a);
+  genome.AddNeuron(b);
+  genome.AddLink(Link(in, dead_end.GetId(), 1.0));
+  genome.AddLink(Link(in, out, 2.0));
+  Link disabled(in, out, 5.0);
+  genome.AddLink(disabled);
+  genome.DisableLink(disabled.GetId());
+  genome.AddLink(Link(a.GetId(), b.GetId(), 1.0));
+  genome.AddLink(Link(b.GetId(), a.GetId(), 1.0));
+  genome.AddLink(Link(b.GetId(), out, 1.0));
+
+  std::vector<std::vector<Neuron>> layers = get_layers(genome);
+  EXPECT_EQ(layers.front().size(), 1);
+  EXPECT_EQ(layers.back().size(), 1);
+
+  NeuralNetwork neural_network(genome);
+  std::vector<FeedForwardNeuron> ffneurons = neural_network.GetNeurons();
+  EXPECT_EQ(ffneurons.size(), 4);
+  for (const FeedForwardNeuron& ffneuron : ffneurons) {
+    EXPECT_NE(ffneuron.id, dead_end.GetId());
+  }
+  std::vector<double> output_values = neural_network.Activate({1.0});
+  ASSERT_EQ(output_values.size(), 1);
+  EXPECT_DOUBLE_EQ(output_values[0], 2.0);
+}
+
 /*!
  * @brief Tests the activation function of the NeuralNetwork constructed from a
  * Genome.
@@ -579,6 +843,189 @@ TEST(NeatTests, NeuralNetworkActivate_with_cycles) {
   }*/
 }
 
+/*!
+ * @brief Tests the compiled activation against hand-computed values.
+ *
+ * @details Builds a network with one relu hidden neuron and checks that the
+ * output written into a caller-provided buffer matches the expected value and
+ * that the buffer is reused between activations.
+ */
+TEST(NeatTests, NeuralNetworkActivateIntoBuffer) {
+  Genome genome(2, 1);
+  std::vector<Neuron> neurons = genome.GetNeurons();
+  std::int64_t in1 = neurons[0].GetId();
+  std::int64_t in2 = neurons[1].GetId();
+  std::int64_t out = neurons[2].GetId();
+  Neuron hidden(NeuronType::kHidden, -1.0);
+  hidden.SetActivation(ActivationType::relu);
+  genome.AddNeuron(hidden);
+  genome.AddLink(Link(in1, hidden.GetId(), 1.0));
+  genome.AddLink(Link(in2, hidden.GetId(), 1.0));
+  genome.AddLink(Link(hidden.GetId(), out, 1.0));
+
+  NeuralNetwork neural_network(genome);
+  EXPECT_EQ(neural_network.GetInputCount(), 2);
+  EXPECT_EQ(neural_network.GetOutputCount(), 1);
+
+  std::vector<double> output_values;
+  neural_network.Activate({1, 3}, output_values);
+  ASSERT_EQ(output_values.size(), 1);
+  EXPECT_DOUBLE_EQ(output_values[0], 3.0);
+
+  const double* buffer = output_values.data();
+  neural_network.Activate({-2, 1}, output_values);
+  EXPECT_EQ(output_values.data(), buffer);
+  EXPECT_DOUBLE_EQ(output_values[0], 0.0);
+}
+
+/*!
+ * @brief Tests that identical genomes share one compiled network while
+ * keeping their own recurrent state.
+ */
+TEST(NeatTests, NetworkCacheSharesCompiledNetwork) {
+  Genome genome(1, 1);
+  std::int64_t in = genome.GetNeurons()[0].GetId();
+  std::int64_t out = genome.GetNeurons()[1].GetId();
+  Neuron hidden(NeuronType::kHidden, 0.0);
+  genome.AddNeuron(hidden);
+  genome.AddLink(Link(in, hidden.GetId(), 1.0));
+  genome.AddLink(Link(hidden.GetId(), out, 1.0));
+  Link cyclink(out, hidden.GetId(), 1.0);
+  cyclink.SetCyclic();
+  genome.AddLink(cyclink);
+  Genome copy = genome;
+  ASSERT_TRUE(copy == genome);
+  EXPECT_EQ(copy.GetHash(), genome.GetHash());
+
+  NeuralNetwork first(genome);
+  NeuralNetwork second(copy);
+  EXPECT_EQ(first.GetCompiled(), second.GetCompiled());
+
+  // the state carried by the cycle must not leak between the two brains
+  EXPECT_DOUBLE_EQ(first.Activate({1.0})[0], 1.0);
+  EXPECT_DOUBLE_EQ(first.Activate({1.0})[0], 2.0);
+  EXPECT_DOUBLE_EQ(second.Activate({1.0})[0], 1.0);
+
+  Genome other(1, 1);
+  NeuralNetwork third(other);
+  EXPECT_NE(first.GetCompiled(), third.GetCompiled());
+}
+
+/*!
+ * @brief Tests that batched activation matches the scalar activation.
+ *
+ * @details Activates two networks sharing a shape (with different weights)
+ * and one network of another shape through a NeuralNetworkBatch, several
+ * times so that recurrent state is carried, and compares against independent
+ * copies activated one by one.
+ */
+TEST(NeatTests, NeuralNetworkBatchMatchesScalar) {
+  Genome genome(3, 2);
+  std::vector<Neuron> neurons = genome.GetNeurons();
+  Neuron hidden(NeuronType::kHidden, 0.2);
+  hidden.SetActivation(ActivationType::sigmoid);
+  genome.AddNeuron(hidden);
+  genome.AddLink(Link(neurons[0].GetId(), hidden.GetId(), 0.7));
+  genome.AddLink(Link(neurons[1].GetId(), hidden.GetId(), -0.3));
+  genome.AddLink(Link(hidden.GetId(), neurons[3].GetId(), 1.5));
+  genome.AddLink(Link(neurons[2].GetId(), neurons[4].GetId(), 0.9));
+  Link cyclink(neurons[3].GetId(), hidden.GetId(), 0.5);
+  cyclink.SetCyclic();
+  genome.AddLink(cyclink);
+
+  Genome reweighted;
+  for (const Neuron& neuron : genome.GetNeurons()) reweighted.AddNeuron(neuron);
+  for (const Link& link : genome.GetLinks()) {
+    reweighted.AddLink(Link(link.GetId(), link.GetInId(), link.GetOutId(),
+                            link.GetWeight() * -2.0, link.IsActive(),
+                            link.IsCyclic()));
+  }
+  Genome other(3, 2);
+  other.AddLink(Link(other.GetNeurons()[0].GetId(),
+                     other.GetNeurons()[3].GetId(), 1.0));
+
+  std::vector<Genome> genomes = {genome, reweighted, other};
+  std::vector<NeuralNetwork> batched;
+  std::vector<NeuralNetwork> scalar;
+  for (const Genome& g : genomes) {
+    batched.emplace_back(g);
+    scalar.emplace_back(g);
+  }
+
+  std::vector<std::vector<double> > inputs = {
+      {1.0, 0.5, -1.0}, {0.2, -0.4, 2.0}, {3.0, 1.0, 0.0}};
+  std::vector<std::vector<double> > outputs(3);
+  NeuralNetworkBatch batch;
+  for (int step = 0; step < 3; step++) {
+    batch.Clear();
+    for (int i = 0; i < 3; i++) batch.Add(batched[i], inputs[i], outputs[i]);
+    EXPECT_EQ(batch.GetSize(), 3);
+    batch.Activate();
+    for (int i = 0; i < 3; i++) {
+      std::vector<double> expected = scalar[i].Activate(inputs[i]);
+      ASSERT_EQ(outputs[i].size(), expected.size());
+      for (int j = 0; j < expected.size(); j++) {
+        EXPECT_DOUBLE_EQ(outputs[i][j], expected[j]);
+      }
+    }
+  }
+}
+
+/*!
+ * @brief Tests the float and int8 modes of the batched activation.
+ *
+ * @details In each mode the batch must reproduce the scalar activation of the
+ * same mode exactly, stay close to the double precision result, and report
+ * the drift it measured against it.
+ */
+TEST(NeatTests, NeuralNetworkBatchReducedPrecision) {
+  Genome genome(3, 2);
+  std::vector<Neuron> neurons = genome.GetNeurons();
+  Neuron hidden(NeuronType::kHidden, 0.2);
+  hidden.SetActivation(ActivationType::sigmoid);
+  genome.AddNeuron(hidden);
+  genome.AddLink(Link(neurons[0].GetId(), hidden.GetId(), 0.7));
+  genome.AddLink(Link(neurons[1].GetId(), hidden.GetId(), -0.3));
+  genome.AddLink(Link(hidden.GetId(), neurons[3].GetId(), 1.5));
+  genome.AddLink(Link(neurons[2].GetId(), neurons[4].GetId(), 0.9));
+  Link cyclink(neurons[3].GetId(), hidden.GetId(), 0.5);
+  cyclink.SetCyclic();
+  genome.AddLink(cyclink);
+
+  std::vector<std::vector<double> > inputs = {{1.0, 0.5, -1.0},
+                                              {0.2, -0.4, 2.0}};
+  for (Precision precision : {Precision::kFloat, Precision::kInt8}) {
+    std::vector<NeuralNetwork> batched(2, NeuralNetwork(genome));
+    std::vector<NeuralNetwork> scalar(2, NeuralNetwork(genome));
+    std::vector<std::vector<double> > outputs(2);
+    NeuralNetworkBatch batch;
+    batch.SetPrecision(precision);
+    batch.SetValidation(true);
+    for (int step = 0; step < 3; step++) {
+      batch.Clear();
+      for (int i = 0; i < 2; i++) batch.Add(batched[i], inputs[i], outputs[i]);
+      batch.Activate();
+
+      double max_drift = 0;
+      for (int i = 0; i < 2; i++) {
+        // drift of one step from the state reached in reduced precision
+        NeuralNetwork exact = scalar[i];
+        std::vector<double> reference = exact.Activate(inputs[i]);
+        std::vector<double> expected;
+        scalar[i].Activate(inputs[i], expected, precision);
+        ASSERT_EQ(outputs[i].size(), expected.size());
+        for (int j = 0; j < expected.size(); j++) {
+          EXPECT_DOUBLE_EQ(outputs[i][j], expected[j]);
+          EXPECT_NEAR(outputs[i][j], reference[j], 0.05);
+          max_drift = std::max(max_drift, std::fabs(outputs[i][j] - reference[j]));
+        }
+      }
+      EXPECT_DOUBLE_EQ(batch.GetMaxDrift(), max_drift);
+      EXPECT_LE(batch.GetMeanDrift(), batch.GetMaxDrift());
+    }
+  }
+}
+
 /*!
  * @brief Tests the crossover functionality for Neuron objects.
  *
@@ -854,3 +1301,58 @@ TEST(CompatibilityTests, PartialCompatibility) {
 //  // Verify zero compatibility
 //  EXPECT_EQ(compatibility_score, 0);
 //}
+
+/*!
+ * @brief Tests that the compatibility cache returns the computed distance and
+ * serves repeated lookups, in either order, from memory.
+ */
+TEST(NeatTests, CompatibilityCacheMemoisesDistance) {
+  auto first = std::make_shared<Genome>(2, 2);
+  first->AddLink(Link(first->GetNeurons()[0].GetId(),
+                      first->GetNeurons()[2].GetId(), 1.0));
+  auto second = std::make_shared<Genome>(*first);
+  second->AddNeuron(Neuron(NeuronType::kHidden, 0.5));
+  double expected = first->CompatibilityBetweenGenomes(*second);
+
+  CompatibilityCache &cache = CompatibilityCache::GetInstance();
+  cache.Clear();
+  EXPECT_DOUBLE_EQ(
+      cache.Distance(first, first->GetHash(), second, second->GetHash()),
+      expected);
+  EXPECT_DOUBLE_EQ(
+      cache.Distance(second, second->GetHash(), first, first->GetHash()),
+      expected);
+  EXPECT_EQ(cache.GetMisses(), 1);
+  EXPECT_EQ(cache.GetHits(), 1);
+  EXPECT_DOUBLE_EQ(cache.GetHitRate(), 0.5);
+  EXPECT_EQ(cache.GetSize(), 1);
+}
+
+/*!
+ * @brief Tests that pairs whose hashes collide each get their own distance
+ * from the compatibility cache.
+ */
+TEST(NeatTests, CompatibilityCacheSeparatesHashCollisions) {
+  auto first = std::make_shared<Genome>(2, 2);
+  auto second = std::make_shared<Genome>(*first);
+  second->AddNeuron(Neuron(NeuronType::kHidden, 0.5));
+  auto third = std::make_shared<Genome>(*second);
+  third->AddLink(Link(third->GetNeurons()[0].GetId(),
+                      third->GetNeurons()[2].GetId(), 1.0));
+  third->AddLink(Link(third->GetNeurons()[1].GetId(),
+                      third->GetNeurons()[3].GetId(), 1.0));
+  ASSERT_NE(first->CompatibilityBetweenGenomes(*second),
+            first->CompatibilityBetweenGenomes(*third));
+
+  CompatibilityCache &cache = CompatibilityCache::GetInstance();
+  cache.Clear();
+  // the same made up hashes for both pairs
+  EXPECT_DOUBLE_EQ(cache.Distance(first, 1, second, 2),
+                   first->CompatibilityBetweenGenomes(*second));
+  EXPECT_DOUBLE_EQ(cache.Distance(first, 1, third, 2),
+                   first->CompatibilityBetweenGenomes(*third));
+  EXPECT_DOUBLE_EQ(cache.Distance(first, 1, third, 2),
+                   first->CompatibilityBetweenGenomes(*third));
+  EXPECT_EQ(cache.GetMisses(), 2);
+  EXPECT_EQ(cache.GetHits(), 1);
+}
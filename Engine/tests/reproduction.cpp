@@ -2,7 +2,11 @@
 
 #include <iostream>
 
+#include "core/id_service.h"
+#include "core/random.h"
+#include "core/thread_pool.h"
 #include "entity/creature/egg.h"
+#include "simulation/creature_manager.h"
 
 TEST(ReproductionTest, SimulatePregnancy) {
   neat::Genome genome(4, 4);
@@ -34,3 +38,150 @@ TEST(ReproductionTest, SimulatePregnancy) {
   ASSERT_FALSE(female.FemaleReproductiveSystem::IsPregnant());
   ASSERT_FALSE(female.FemaleReproductiveSystem::CanBirth());
 }
+
+TEST(ReproductionTest, HatchSharesGenome) {
+  auto genome = std::make_shared<const neat::Genome>(4, 4);
+  Mutable mutables;
+  Creature parent(genome, mutables);
+  EXPECT_EQ(parent.GetSharedGenome(), genome);
+
+  GestatingEgg gestating_egg(parent.GetSharedGenome(), mutables, 1);
+  gestating_egg.age = gestating_egg.incubation_time;
+  Egg egg(gestating_egg, {1.0, 1.0});
+  std::shared_ptr<Creature> hatchling = egg.Hatch();
+
+  EXPECT_EQ(hatchling->GetSharedGenome(), genome);
+  EXPECT_EQ(&hatchling->GetGenome(), &parent.GetGenome());
+}
+
+TEST(ReproductionTest, ConceptionIsReproducibleFromItsJobSeed) {
+  auto genome = std::make_shared<const neat::Genome>(4, 4);
+  Mutable mutables;
+  Creature father(genome, mutables);
+  Creature mother(genome, mutables);
+
+  Random::SetSeed(7);
+  double expected_draw = Random::Double(0, 1);
+
+  Random::SetSeed(7);
+  std::vector<GestatingEgg> eggs;
+  for (int i = 0; i < 2; i++) {
+    Random::ScopedSeed seed(42, 3);
+    eggs.push_back(Conceive(father, mother));
+  }
+  EXPECT_EQ(Random::Double(0, 1), expected_draw);
+
+  EXPECT_EQ(eggs[0].mutables.GetMaxSize(), eggs[1].mutables.GetMaxSize());
+  EXPECT_EQ(eggs[0].mutables.GetColor(), eggs[1].mutables.GetColor());
+  EXPECT_EQ(eggs[0].genome->GetNeurons().size(),
+            eggs[1].genome->GetNeurons().size());
+  EXPECT_EQ(eggs[0].genome->GetLinks().size(),
+            eggs[1].genome->GetLinks().size());
+  EXPECT_EQ(eggs[0].generation, 1);
+}
+
+TEST(ReproductionTest, EggDefersBrainToHatch) {
+  static_assert(!std::is_base_of_v<AliveEntity, Egg>,
+                "eggs must not build a neural network");
+  auto genome = std::make_shared<const neat::Genome>(4, 4);
+  Mutable mutables;
+  GestatingEgg gestating_egg(genome, mutables, 3);
+  Egg egg(gestating_egg, {12.0, 34.0});
+  EXPECT_EQ(egg.GetSharedGenome(), genome);
+  EXPECT_EQ(egg.GetGenomeHash(), genome->GetHash());
+  EXPECT_THROW(egg.Hatch(), std::runtime_error);
+
+  egg.Update(egg.GetIncubationTime());
+  std::shared_ptr<Creature> hatchling = egg.Hatch();
+  EXPECT_EQ(hatchling->GetSharedGenome(), genome);
+  EXPECT_EQ(hatchling->GetGeneration(), 3);
+  EXPECT_EQ(hatchling->GetCoordinates(), std::make_pair(12.0, 34.0));
+  EXPECT_TRUE(egg.CompatibleWithCreature(*hatchling));
+}
+
+/*!
+ * @brief Tests that a seeded generation, conceived and hatched on the pool,
+ * gets the same ids and genomes on one thread as on several.
+ */
+TEST(ReproductionTest, OffspringDoNotDependOnThreadCount) {
+  std::int64_t first_ids[IdService::kKindCount];
+  for (int kind = 0; kind < IdService::kKindCount; kind++) {
+    first_ids[kind] =
+        IdService::Peek(static_cast<IdService::Kind>(kind)) + (1 << 20);
+  }
+  const int threads = ThreadPool::Global().GetThreadCount();
+
+  auto generation = [&](int thread_count) {
+    ThreadPool::Global().Resize(thread_count, false);
+    for (int kind = 0; kind < IdService::kKindCount; kind++) {
+      IdService::Reset(static_cast<IdService::Kind>(kind), first_ids[kind]);
+    }
+    Random::SetSeed(5);
+
+    Environment environment;
+    SimulationData data(environment);
+    auto genome = std::make_shared<const neat::Genome>(4, 4);
+    Mutable mutables;
+    for (int pair = 0; pair < 8; pair++) {
+      for (double offset : {0.0, 1.0}) {
+        auto creature = std::make_shared<Creature>(genome, mutables);
+        creature->SetCoordinates(100.0 + 200.0 * pair + offset, 100.0);
+        creature->SetAge(creature->MaleReproductiveSystem::GetMaturityAge() +
+                         10);
+        creature->SetWaitingToReproduce(true);
+        data.creatures_.push_back(creature);
+      }
+    }
+    const int parents = data.creatures_.size();
+
+    CreatureManager creature_manager;
+    creature_manager.ReproduceCreatures(data, environment);
+    for (int i = 0; i < parents; i++) {
+      auto& mother = data.creatures_[i];
+      if (!mother->FemaleReproductiveSystem::IsPregnant()) continue;
+      GestatingEgg egg = mother->FemaleReproductiveSystem::GetEgg();
+      egg.age = egg.incubation_time;
+      data.eggs_.push_back(
+          std::make_shared<Egg>(egg, mother->GetCoordinates()));
+    }
+    creature_manager.HatchEggs(data, environment);
+    data.commands_.Apply(data);
+    return std::vector<std::shared_ptr<Creature>>(
+        data.creatures_.begin() + parents, data.creatures_.end());
+  };
+  std::vector<std::shared_ptr<Creature>> serial = generation(1);
+  std::vector<std::shared_ptr<Creature>> parallel = generation(4);
+  ThreadPool::Global().Resize(threads, SETTINGS.engine.pin_threads);
+
+  ASSERT_FALSE(serial.empty());
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (int i = 0; i < serial.size(); i++) {
+    EXPECT_EQ(serial[i]->GetID(), parallel[i]->GetID());
+    EXPECT_TRUE(serial[i]->GetGenome() == parallel[i]->GetGenome());
+  }
+}
+
+/*!
+ * @brief Tests that a tick reserves entity ids only for what the creatures
+ * spawn, here the meat of the one that dies.
+ */
+TEST(ReproductionTest, TickTakesOnlyTheEntityIdsItSpawns) {
+  Environment environment;
+  SimulationData data(environment);
+  auto genome = std::make_shared<const neat::Genome>(
+      SETTINGS.environment.input_neurons, SETTINGS.environment.output_neurons);
+  Mutable mutables;
+  for (int i = 0; i < 8; i++) {
+    auto creature = std::make_shared<Creature>(genome, mutables);
+    creature->SetCoordinates(100.0 + 50.0 * i, 100.0);
+    data.creatures_.push_back(creature);
+  }
+  EntityGrid entity_grid;
+  entity_grid.UpdateGrid(data, environment, 0.0);
+  data.creatures_[3]->Dies();
+
+  CreatureManager creature_manager;
+  const std::int64_t before = IdService::Peek(IdService::kEntity);
+  creature_manager.UpdateAllCreatures(data, environment, entity_grid, 0.01);
+  EXPECT_EQ(IdService::Peek(IdService::kEntity), before + 1);
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "core/scratch_arena.h"
+#include "core/thread_pool.h"
+
+TEST(ThreadPoolTests, LoopsVisitEveryIterationOnce) {
+  ThreadPool pool(4);
+  ASSERT_EQ(pool.GetThreadCount(), 4);
+  const int kCount = 1000;
+
+  std::vector<std::atomic<int>> visits(kCount);
+  pool.ParallelFor(0, kCount, [&](int i) { visits[i]++; });
+  // cheap and expensive iterations, and a loop nested in each chunk
+  pool.ParallelForWeighted(
+      0, kCount, [](int i) { return i % 10 == 0 ? 100.0 : 1.0; },
+      [&](int i) {
+        pool.ParallelFor(0, 2, [&](int) { visits[i]++; });
+      });
+  for (int i = 0; i < kCount; i++) EXPECT_EQ(visits[i].load(), 3);
+
+  std::atomic<int> outside(0);
+  pool.ParallelFor(
+      0, kCount,
+      [&](int) {
+        const int index = ThreadPool::ThreadIndex();
+        if (index < 0 || index >= pool.GetThreadCount()) outside++;
+      },
+      1);
+  EXPECT_EQ(outside.load(), 0);
+  EXPECT_EQ(ThreadPool::ThreadIndex(), 0);
+
+  long sum = pool.ParallelReduce(
+      0, kCount, 0L, [](int i) { return static_cast<long>(i); },
+      [](long a, long b) { return a + b; });
+  EXPECT_EQ(sum, kCount * (kCount - 1L) / 2);
+
+  EXPECT_THROW(pool.ParallelFor(0, kCount,
+                                [](int i) {
+                                  if (i == 500) throw std::runtime_error("");
+                                }),
+               std::runtime_error);
+
+  pool.Resize(1, false);
+  EXPECT_EQ(pool.GetThreadCount(), 1);
+  EXPECT_EQ(pool.ParallelReduce(
+                0, 10, 0, [](int i) { return i; },
+                [](int a, int b) { return a + b; }),
+            45);
+}
+
+TEST(ScratchArenaTests, SteadyTicksReuseOneBlock) {
+  ScratchArena& arena = ScratchArena::Local();
+  auto tick = [] {
+    ScratchVector<int> values;
+    for (int i = 0; i < 100000; i++) values.push_back(i);
+    ScratchVector<double> more(5000, 1.0);
+    EXPECT_EQ(values[99999], 99999);
+    EXPECT_EQ(more[4999], 1.0);
+  };
+
+  ScratchArena::ResetAll();
+  tick();
+  EXPECT_GT(arena.GetBlockCount(), 1);
+  ScratchArena::ResetAll();
+  EXPECT_EQ(arena.GetBlockCount(), 1);
+  const std::size_t capacity = arena.GetCapacity();
+
+  for (int i = 0; i < 3; i++) {
+    tick();
+    EXPECT_EQ(arena.GetBlockCount(), 1);
+    EXPECT_EQ(arena.GetCapacity(), capacity);
+    ScratchArena::ResetAll();
+  }
+
+  void* aligned = arena.Allocate(8, 64);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 64, 0);
+  ScratchArena::ResetAll();
+}
@@ -35,7 +35,7 @@ public:
   int GetSelectedSpecies() const;
 
 private:
-  int selected_id_ = -1;
+  int selected_species_ = -1;
 
   QSFMLCanvas* canvas_;
   Simulation* simulation_;
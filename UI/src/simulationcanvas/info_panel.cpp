@@ -110,20 +110,20 @@ std::string InfoPanel::FormatCreatureInfo(const Creature& creature) {
 
 void InfoPanel::SetSelectedSpecies(int id) {
   qDebug() << "species id set to " << id;
-  selected_id_ = id;
+  selected_species_ = id;
 }
 
 void InfoPanel::RemoveSelectedSpecies() {
-  selected_id_ = -1;
+  selected_species_ = -1;
 }
 
 int InfoPanel::GetSelectedSpecies() const {
-  return selected_id_;
+  return selected_species_;
 }
 
 void InfoPanel::DrawCircle(const Creature& creature, sf::Color color = sf::Color::Red) {
   canvas_->setView(ui_view_);
-  if (GetSelectedCreature() && creature.GetID() != GetSelectedCreature()->GetID() && selected_id_ == -1) return;
+  if (GetSelectedCreature() && creature.GetID() != GetSelectedCreature()->GetID() && selected_species_ == -1) return;
   sf::CircleShape redCircle(creature.GetSize()); // Adjust as needed
   redCircle.setOutlineColor(color);
   redCircle.setOutlineThickness(creature.GetSize()/3); // Adjust thickness as needed
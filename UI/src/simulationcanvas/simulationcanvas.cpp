@@ -196,7 +196,7 @@ void SimulationCanvas::RenderSimulation(SimulationData& data) {
   for (const auto& creature_ptr : data.creatures_) {
     if (creature_ptr == nullptr) continue;
     auto& creature_ref = *creature_ptr;
-    int id = creature_ref.GetID(); //Not sure but I think this line and the above aren't used
+    std::int64_t id = creature_ref.GetID(); //Not sure but I think this line and the above aren't used
     std::shared_ptr<Creature> creature = creature_ptr;
     auto renderPositions = getEntityRenderPositions(creature);
     for (const auto& pos : renderPositions) {